@@ -15,21 +15,264 @@
 
 #include "include/raylib.h"
 #include "include/raymath.h"
+#include "include/rlgl.h"
 #define RAYGUI_IMPLEMENTATION
 #include "include/raygui.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <stdint.h>
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    #include <tmmintrin.h>
+#endif
+
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <errno.h>
+#endif
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    #include <poll.h>
+    // Xlib has its own Font type, keep raylib's visible
+    #define Font X11Font
+    #include <X11/Xlib.h>
+    #include <X11/Xutil.h>
+    #include <X11/extensions/XShm.h>
+    #include <X11/extensions/Xcomposite.h>
+    #undef Font
+    #include <sys/ipc.h>
+    #include <sys/shm.h>
+    #include <sys/syscall.h>
+    // io_uring is called through raw syscalls, only the kernel's uapi header is needed
+    #if defined(__has_include)
+        #if __has_include(<linux/io_uring.h>)
+            #include <linux/io_uring.h>
+            #define HAVE_IO_URING 1
+        #endif
+    #endif
+#endif
+#if !defined(PLATFORM_WEB)
+    // raylib already resolved every GL entry point through glad, we call the few it doesn't wrap through the same pointers
+    #include <stddef.h>
+    #define GL_TEXTURE_2D 0x0DE1
+    #define GL_UNSIGNED_BYTE 0x1401
+    #define GL_ONE 1
+    #define GL_BGRA 0x80E1
+    #define GL_TEXTURE_SWIZZLE_A 0x8E45
+    #define GL_PIXEL_UNPACK_BUFFER 0x88EC
+    #define GL_STREAM_DRAW 0x88E0
+    #define GL_MAP_WRITE_BIT 0x0002
+    #define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+    #define GL_ARRAY_BUFFER 0x8892
+    #define GL_TIMESTAMP 0x8E28
+    #define GL_QUERY_COUNTER_BITS 0x8864
+    #define GL_QUERY_RESULT 0x8866
+    #define GL_QUERY_RESULT_AVAILABLE 0x8867
+    #define GL_RED 0x1903
+    #define GL_RG 0x8227
+    #define GL_RGB 0x1907
+    #define GL_RGBA 0x1908
+    #define GL_FLOAT 0x1406
+    #define GL_HALF_FLOAT 0x140B
+    #define GL_UNSIGNED_SHORT_4_4_4_4 0x8033
+    #define GL_UNSIGNED_SHORT_5_5_5_1 0x8034
+    #define GL_UNSIGNED_SHORT_5_6_5 0x8363
+    #define GL_RENDERER 0x1F01
+    #define GL_VERSION 0x1F02
+    #define GL_NEAREST 0x2600
+    #define GL_TEXTURE_MAG_FILTER 0x2800
+    #define GL_TEXTURE_MIN_FILTER 0x2801
+    #define GL_UNSIGNED_INT 0x1405
+    #define GL_R32UI 0x8236
+    #define GL_RED_INTEGER 0x8D94
+    #define GL_COLOR 0x1800
+    #define GL_DEPTH 0x1801
+    #define GL_PIXEL_PACK_BUFFER 0x88EB
+    #define GL_STREAM_READ 0x88E1
+    #define GL_MAP_READ_BIT 0x0001
+    #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+    #define GL_ALREADY_SIGNALED 0x911A
+    #define GL_CONDITION_SATISFIED 0x911C
+    extern void (*glad_glGenBuffers)(int n, unsigned int *buffers);
+    extern void (*glad_glDeleteBuffers)(int n, const unsigned int *buffers);
+    extern void (*glad_glBindBuffer)(unsigned int target, unsigned int buffer);
+    extern void (*glad_glBufferData)(unsigned int target, ptrdiff_t size, const void *data, unsigned int usage);
+    extern void *(*glad_glMapBufferRange)(unsigned int target, ptrdiff_t offset, ptrdiff_t length, unsigned int access);
+    extern unsigned char (*glad_glUnmapBuffer)(unsigned int target);
+    extern void (*glad_glBindTexture)(unsigned int target, unsigned int texture);
+    extern void (*glad_glTexParameteri)(unsigned int target, unsigned int pname, int param);
+    extern void (*glad_glTexSubImage2D)(unsigned int target, int level, int x, int y, int width, int height, unsigned int format, unsigned int type, const void *pixels);
+    extern void (*glad_glTexImage2D)(unsigned int target, int level, int internalFormat, int width, int height, int border, unsigned int format, unsigned int type, const void *pixels);
+    extern void (*glad_glCompressedTexImage2D)(unsigned int target, int level, unsigned int internalFormat, int width, int height, int border, int imageSize, const void *data);
+    extern void (*glad_glBufferSubData)(unsigned int target, ptrdiff_t offset, ptrdiff_t size, const void *data);
+    extern void (*glad_glDrawArrays)(unsigned int mode, int first, int count);
+    extern void (*glad_glDrawElements)(unsigned int mode, int count, unsigned int type, const void *indices);
+    extern void (*glad_glDrawArraysInstanced)(unsigned int mode, int first, int count, int instances);
+    extern void (*glad_glDrawElementsInstanced)(unsigned int mode, int count, unsigned int type, const void *indices, int instances);
+    extern void (*glad_glGenQueries)(int n, unsigned int *ids);
+    extern void (*glad_glDeleteQueries)(int n, const unsigned int *ids);
+    extern void (*glad_glQueryCounter)(unsigned int id, unsigned int target);
+    extern void (*glad_glGetQueryiv)(unsigned int target, unsigned int pname, int *params);
+    extern void (*glad_glGetQueryObjectiv)(unsigned int id, unsigned int pname, int *params);
+    extern void (*glad_glGetQueryObjectui64v)(unsigned int id, unsigned int pname, unsigned long long *params);
+    extern const unsigned char *(*glad_glGetString)(unsigned int name);
+    extern void (*glad_glGenTextures)(int n, unsigned int *textures);
+    extern void (*glad_glDeleteTextures)(int n, const unsigned int *textures);
+    extern void (*glad_glReadPixels)(int x, int y, int width, int height, unsigned int format, unsigned int type, void *pixels);
+    extern void (*glad_glClearBufferuiv)(unsigned int buffer, int drawbuffer, const unsigned int *value);
+    extern void (*glad_glClearBufferfv)(unsigned int buffer, int drawbuffer, const float *value);
+    extern void *(*glad_glFenceSync)(unsigned int condition, unsigned int flags);
+    extern unsigned int (*glad_glClientWaitSync)(void *sync, unsigned int flags, unsigned long long timeout);
+    extern void (*glad_glDeleteSync)(void *sync);
+    #define glGenBuffers glad_glGenBuffers
+    #define glDeleteBuffers glad_glDeleteBuffers
+    #define glBindBuffer glad_glBindBuffer
+    #define glBufferData glad_glBufferData
+    #define glMapBufferRange glad_glMapBufferRange
+    #define glUnmapBuffer glad_glUnmapBuffer
+    #define glBindTexture glad_glBindTexture
+    #define glTexParameteri glad_glTexParameteri
+    #define glTexSubImage2D glad_glTexSubImage2D
+    #define glGenQueries glad_glGenQueries
+    #define glDeleteQueries glad_glDeleteQueries
+    #define glQueryCounter glad_glQueryCounter
+    #define glGetQueryiv glad_glGetQueryiv
+    #define glGetQueryObjectiv glad_glGetQueryObjectiv
+    #define glGetQueryObjectui64v glad_glGetQueryObjectui64v
+    #define glGetString glad_glGetString
+    #define glTexImage2D glad_glTexImage2D
+    #define glGenTextures glad_glGenTextures
+    #define glDeleteTextures glad_glDeleteTextures
+    #define glReadPixels glad_glReadPixels
+    #define glClearBufferuiv glad_glClearBufferuiv
+    #define glClearBufferfv glad_glClearBufferfv
+    #define glFenceSync glad_glFenceSync
+    #define glClientWaitSync glad_glClientWaitSync
+    #define glDeleteSync glad_glDeleteSync
 #endif
 
 #define NUM_BALL_ROWS  5
 #define NUM_BALL_COLS  5
 #define NUM_REACTION_BALLS 25
-#define NUM_BALLS_ON_SCREEN 3
+#define NUM_BALLS_ON_SCREEN 5         // most targets up at once, adaptive rounds go as high as this
+#define REACTION_TARGETS 3            // targets up at once in a normal round
+#define REACTION_ROUND_SECONDS 30.0f
+#define REACTION_HIT_PADDING 5.0f    // added to the ball radius when testing clicks
+#define REACTION_BALL_SPACING 70.0f  // gap between the grid positions balls appear at
+#define REACTION_INPUT_CLICK 1u      // left button went down this frame
+
+#define MOTION_TICK (1.0f/240.0f)    // targets move in fixed steps whatever the frame rate
+#define MOTION_LANES 8               // motion slots in a round, NUM_BALLS_ON_SCREEN rounded up to whole SSE registers
+#define MOTION_OFFSET_X 60.0f        // how far a moving target may leave its grid position
+#define MOTION_OFFSET_Y 40.0f
+#define MOTION_NEVER 1e30f           // burst period of targets that don't burst
+#define SPHERE_LOD_LEVELS 5          // target tessellations, the last one is raylib's DrawSphere 16x16
+#define SPHERE_LOD_HYSTERESIS 0.2f   // a target has to get this much past a threshold before its level changes
+#define BENCH_MOTION_TICKS 4         // motion steps per benchmark frame, 60 Hz worth
+#define HUMANOID_SCALE 0.6f          // humanoid units per ball size, a humanoid is about as tall as two balls stacked
+#define HUMANOID_SHAPES 7            // capsules and boxes a humanoid is made of
+#define HITBOX_BENCH_RAYS 200000     // rays --hitbox-bench fires at the crowd
+
+#define ADAPTIVE_WINDOW 32            // clicks the rolling hit rate and reaction times cover
+#define ADAPTIVE_MIN_SAMPLES 8        // clicks before the controller starts steering
+#define ADAPTIVE_BUCKETS 40           // reaction time histogram, the last bucket holds everything slower
+#define ADAPTIVE_BUCKET_SECONDS 0.05f
+#define ADAPTIVE_HIT_RATE 0.85f       // accuracy the target size steers towards
+#define ADAPTIVE_REACTION 0.6f        // seconds the ADAPTIVE_PERCENTILE reaction time steers towards
+#define ADAPTIVE_PERCENTILE 0.75f
+#define ADAPTIVE_GAIN 0.2f            // fraction of the error corrected per click
+#define ADAPTIVE_MIN_SIZE 2.0f
+#define ADAPTIVE_MAX_SIZE 40.0f
+#define ADAPTIVE_MIN_SPACING 30.0f
+#define ADAPTIVE_MAX_SPACING 110.0f
+
+#define SCENE_MIN_SCALE 0.4f         // lowest fraction of the window resolution the 3D layer drops to
+#define SCENE_SCALE_GAIN 0.15f       // how much of the measured error the controller corrects per frame
+#define SCENE_SCALE_DEADBAND 0.05f   // frame time error ignored by the controller, keeps the scale from hunting
+#define SCENE_GPU_BUDGET 0.9f        // share of the refresh interval the GPU frame may fill when the timers drive the scale
+#define SCENE_PROBE_STEP 0.05f       // scale added by a probe while vsync hides the headroom
+#define SCENE_PROBE_SECONDS 2.0      // time between probes while they hold
+#define SCENE_PROBE_MAX_SECONDS 32.0 // probes that keep missing frames back off to this
+
+#define UI_FONT_FILE_NAME "incognitoaim.sdffont"
+#define UI_FONT_MAGIC 0x46554149u    // "IAUF"
+#define UI_FONT_SCALE 4              // default font pixels are scaled up this much before the distance field is taken
+#define UI_FONT_SPREAD 6             // atlas pixels on each side of a glyph edge the distance field covers
+#define UI_FONT_ATLAS_WIDTH 512
+
+#define PROFILE_FILE_NAME "incognitoaim.profile"
+#define PROFILE_MAGIC 0x46504149u    // "IAPF"
+#define PROFILE_VERSION 6
+
+#define BG_LIBRARY_DIR "backgrounds" // one file per background keyed by pixel hash, next to the app
+#define BG_LIBRARY_SLOTS 9           // one per number key
+#define BG_LIBRARY_VRAM_BUDGET (256u*1024*1024) // backgrounds kept on the GPU beyond the one on screen must fit in this
+#define BG_FILE_MAGIC 0x46424149u    // "IABF"
+
+#define RENDER_OVERFLOW_SLACK 2048   // a batch flushed with fewer free vertices than this was flushed because it was full
+
+#define GPU_TIMER_FRAMES 4           // frames of timestamp queries in flight, results are read this late at most
+#define GPU_TIMER_SMOOTHING 0.1f     // weight of the newest frame in the on screen averages
+#define GPU_PICK_SIZE 9              // window pixels on a side the ID buffer covers around the crosshair, odd so one sits on it
+#define GPU_PICK_READBACKS 4         // clicks whose ID pixel can be in flight at once
+
+#define BENCH_REPORT_FILE "bench.json" // where --bench writes its report when no path is given
+#define BENCH_FRAMES 300             // measured frames per scene
+#define BENCH_WARMUP_FRAMES 30       // frames per scene thrown away while uploads and caches settle
+#define BENCH_SCENE_SECONDS 20.0     // a scene stops early past this, 10k spheres run at a few fps on weak GPUs
+
+#define AIM_MOVE_SPEED 0.1f          // crosshair speed in radians per second that counts as moving
+#define AIM_STOP_SPEED 0.05f         // below this the crosshair has come to rest
+#define AIM_PEAK_DROP 0.5f           // a speed peak ends once speed falls under this fraction of it, and the next starts back over the valley divided by it
+#define AIM_SPEED_SMOOTHING 0.5f     // weight of the newest frame in the speed, mouse deltas arrive quantized
+
+#define SESSION_DIR "sessions"        // one file per finished round, next to the app
+#define SESSION_MAGIC 0x53534149u    // "IASS"
+#define SESSION_VERSION 5
+#define REPLAY_KEYFRAME_SECONDS 0.5f // a seek re-simulates at most this much of a session
+#define REPLAY_SKIP_SECONDS 5.0f     // left/right arrow jump in the replay viewer
+
+#define CLIPBOARD_TIMEOUT 1.0         // seconds to wait on the clipboard owner before giving up
+
+#define JOB_DEQUE_SIZE 64             // jobs queued per worker, a power of two
+#define JOB_FRAME_BUDGET 0.002        // seconds of completions the main thread runs per frame
+#define JOB_SAMPLE_SECONDS 0.5        // how often worker utilization is measured
+
+#define EVENT_LOG_FILE_NAME "incognitoaim.events" // every spawn, hit and miss of the reaction drill, appended forever
+#define EVENT_LOG_MAGIC 0x56454149u   // "IAEV"
+#define EVENT_LOG_VERSION 1
+#define EVENT_BATCH_MAGIC 0x42454149u // "IAEB"
+#define EVENT_QUEUE_SIZE 4096         // events the game thread can get ahead of the writer, a power of two
+#define EVENT_FLUSH_SECONDS 0.1       // how often the writer commits, about what a crash can lose
+#define EXPORT_ROW_GROUP_ROWS 65536   // events per parquet row group, all --export-events holds in memory
+#define EXPORT_NAME_MAX 64            // longest player name exported, the rest is cut
+
+#define DECODE_MAX_THREADS 16         // upper bound on decode threads, screenshots stop scaling past this
+#define INFLATE_FAST_BITS 10          // huffman codes up to this long decode with a single table probe
+#define INFLATE_PUBLISH_BYTES (64*1024) // how often the inflate thread tells the row decoder how far it got
+#define JPEG_FAST_BITS 9
+#define JPEG_CONVERT_ROWS 64          // rows per color conversion task
+
+#define LIVE_MIN_INTERVAL 0.5         // seconds between live background captures at the fastest
+#define LIVE_CPU_BUDGET 0.02          // fraction of one core the capture thread may use, the rate drops to stay under it
 
 #pragma region Structs and enums
 typedef enum{
-    MAIN, REACTION, TRACK
+    MAIN, REACTION, TRACK, REPLAY
 }AppState;
 
 typedef enum{
@@ -55,31 +298,148 @@ typedef struct{
     float pitchLimit;
     float yawLimit;
 }CameraSettings;
+// anything a re-simulation may want to try different values of
+typedef struct{
+    float hitPadding;
+    float ballSpacing;
+    int hitScore;
+    int adaptive;               // size, spread and target count follow the player during the round
+    int motion;                 // MotionPattern of the targets
+    int humanoid;               // targets are humanoids scored per part instead of balls
+}ReactionRules;
+// everything the drill reads from the player in one frame, sessions record these
+typedef struct{
+    float dt;
+    Vector2 mouseDelta;
+    unsigned int buttons;       // REACTION_INPUT_ bits
+}ReactionInput;
+typedef enum{
+    MOTION_STATIC,
+    MOTION_STRAFE,
+    MOTION_SINE,
+    MOTION_WALK,
+    MOTION_BURST,
+    MOTION_MIXED,              // each target picks one of the above when it spawns
+    MOTION_PATTERN_COUNT
+}MotionPattern;
+// one row of floats per field, a lane per target
+typedef enum{
+    MOTION_X, MOTION_Y,                     // offset from the target's anchor
+    MOTION_PREV_X, MOTION_PREV_Y,           // the tick before, drawing and clicks interpolate between the two
+    MOTION_VX, MOTION_VY,
+    MOTION_AX, MOTION_AY,                   // burst acceleration, flips direction every period
+    MOTION_STIFFNESS,                       // pull back to the anchor, makes a sinusoid
+    MOTION_DAMPING,                         // velocity kept per tick
+    MOTION_JITTER,                          // random walk acceleration
+    MOTION_RANGE_X, MOTION_RANGE_Y,
+    MOTION_PHASE,
+    MOTION_PERIOD, MOTION_BURST_TIME,       // acceleration is on for the first BURST_TIME of every PERIOD
+    MOTION_FIELD_COUNT
+}MotionField;
+typedef enum{
+    HITBOX_HEAD,
+    HITBOX_BODY,
+    HITBOX_LIMB,                // arms, legs and anything only the hit padding reached
+    HITBOX_PART_COUNT
+}HitboxPart;
+// a capsule from a to b, or a box from a to b when box is set, in humanoid units around the target position
+typedef struct{
+    Vector3 a;
+    Vector3 b;
+    float radius;
+    bool box;
+    unsigned char part;
+}HitboxShape;
+typedef struct{
+    Vector3 min;
+    Vector3 max;
+    int first;                  // children are first and first + 1, or shapes first to first + count of a leaf
+    int count;
+}HitboxNode;
+// every humanoid shares one BVH in its own units, a ray is moved into them instead of the tree into the world
+typedef struct{
+    HitboxShape shapes[HUMANOID_SHAPES];
+    HitboxNode nodes[2*HUMANOID_SHAPES];
+    int nodeCount;
+    float boundRadius;          // around the target position, rays that miss this never touch the tree
+}HumanoidHitbox;
+typedef struct{
+    float *fields;              // MOTION_FIELD_COUNT rows of capacity floats
+    unsigned int *random;       // a xorshift state per lane for the random walk
+    int capacity;               // a multiple of 4, the kernel has no scalar tail on SSE
+    int count;
+}TargetMotion;
+// the last ADAPTIVE_WINDOW clicks, adding one evicts the oldest so every update is O(1)
+typedef struct{
+    unsigned char hits[ADAPTIVE_WINDOW];
+    unsigned char buckets[ADAPTIVE_WINDOW];     // reaction time bucket of each click, ADAPTIVE_BUCKETS for a miss
+    int histogram[ADAPTIVE_BUCKETS];
+    int head;
+    int count;
+    int hitCount;
+}RollingStats;
+typedef struct{
+    RollingStats stats;
+    float spacing;
+    float clearTime;            // round time of the last hit, the next reaction time counts from here
+    int settle;                 // clicks since the target count last changed
+}AdaptiveDifficulty;
 typedef struct{
     bool balls[NUM_REACTION_BALLS];
     Vector3 ballPositions[NUM_REACTION_BALLS];
     float ballSize;
     int ballOffset;
     Vector3 ballTopLeftPosition;
-    int activeBallIndexs[3];
+    int activeBallIndexs[NUM_BALLS_ON_SCREEN];
+    int targetCount;
+    float startBallSize;        // adaptive rounds change ballSize as they go, sessions replay from this
     GameState gameState;
     Color ballColor;
     int score;
     int numClicks;
+    int hitCount;               // score counts head and body hits extra, accuracy is hits over clicks
+    int partHits[HITBOX_PART_COUNT];
     float accuracy;
     float timer;
     GameState previousState;
     bool hideGame;
+    ReactionRules rules;
+    unsigned int seed;          // the round's ball order replays from this
+    unsigned int random;
+    AdaptiveDifficulty adaptive;
+    // moving targets live in the round itself so snapshots and replays carry them
+    float motionFields[MOTION_FIELD_COUNT*MOTION_LANES];
+    unsigned int motionRandom[MOTION_LANES];
+    float motionTime;           // not yet stepped, as a fraction of MOTION_TICK it is the interpolation weight
 }ReactionGame;
 typedef struct{
     int fontScale;
     int spaccing;
     Vector2 pos;
     float mouseSensitivity;
-    Vector2 sliderSize;
-    Rectangle ballSizeButton;
+    float ballSize;             // the menu's 1 to 10, rounds play at four times this
     float ballColorRectSize;
     int ballColorIndex;
+    // cached by LayoutReactionStartMenu, buttons are hit tested with the same rectangles their labels are drawn at
+    Vector2 sensitivityTextPos;
+    Rectangle sensitivitySlider;
+    Vector2 ballSizeTextPos;
+    Rectangle ballSizeMinus;
+    Rectangle ballSizePlus;
+    Vector2 ballColorTextPos;
+    Rectangle ballColorSwatch;
+    Rectangle ballColorMinus;
+    Rectangle ballColorPlus;
+    Vector2 motionTextPos;
+    Rectangle motionMinus;
+    Rectangle motionPlus;
+    Rectangle compressCheckBox;
+    Vector2 compressTextPos;
+    Rectangle adaptiveCheckBox;
+    Vector2 adaptiveTextPos;
+    Rectangle humanoidCheckBox;
+    Vector2 humanoidTextPos;
+    Vector2 startTextPos;
 }ReactionGameStartMenu;
 typedef struct{
     Texture2D bg_texture;
@@ -88,29 +448,772 @@ typedef struct{
     Vector2 bg_pos;
     bool image_loaded;
 }BackgroundImage;
+typedef struct{
+    unsigned char *data;
+    size_t size;
+}MappedFile;
+// on-disk layout of the profile
+typedef struct{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int headerSize;
+    float mouseSensitivity;
+    float ballSize;
+    int ballColorIndex;
+    int compressBackground;
+    int adaptive;
+    int motion;
+    int humanoid;
+    int libraryCount;
+    int libraryCurrent;
+    unsigned long long libraryHashes[BG_LIBRARY_SLOTS]; // name the background files in BG_LIBRARY_DIR
+}ProfileHeader;
+typedef struct{
+    char path[512];
+    MappedFile file;
+    const ProfileHeader *header;
+}Profile;
+typedef struct{
+    RenderTexture2D target;
+    float scale;
+    float targetFrameTime;
+    float smoothedFrameTime;
+    bool gpuDriven;             // the scene pass timer feeds the controller instead of dt
+    bool probing;               // the last probe has not been judged yet
+    double lastProbe;
+    double probeInterval;
+    int viewWidth;
+    int viewHeight;
+}SceneLayer;
+typedef struct{
+    float startTime;            // round time tracking began, the target's spawn, its last miss or the round start
+    Vector2 start;              // crosshair yaw and pitch at that point
+    Vector2 last;
+    float speed;                // smoothed, radians per second
+    float axial;                // progress along the straight line to the target
+    float axialSpeed;
+    float maxAxial;
+    float path;
+    float peak;
+    float valley;
+    bool armed;                 // waiting for the current speed peak to end
+    float firstMove;            // seconds from startTime, negative until it happens
+    float firstStop;
+    int submovements;
+    int reversals;
+    int lastSign;
+}AimTracker;
+// one per click, written to the session file as is
+typedef struct{
+    float time;                 // round time of the click
+    float reaction;             // seconds until the crosshair started moving, negative if it never did
+    float firstStop;            // seconds until it first came to rest after moving, negative if it never did
+    float duration;
+    float distance;             // degrees from the start to the target
+    float overshoot;            // degrees past the target along the approach
+    float error;                // degrees off the target at the click
+    float efficiency;           // straight line over the path actually taken
+    int submovements;
+    int reversals;
+    int hit;
+}AimSummary;
+// followed by the click summaries and then one input per frame
+typedef struct{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int headerSize;
+    unsigned int summarySize;
+    unsigned int inputSize;
+    long long startTime;        // unix time the round started
+    float duration;
+    float ballSize;
+    float mouseSensitivity;
+    CameraSettings camera;      // as the round started
+    ReactionRules rules;
+    unsigned int seed;
+    int score;
+    int clicks;
+    int summaryCount;
+    int inputCount;
+}SessionHeader;
+typedef struct{
+    long long startTime;
+    float time;
+    AimTracker trackers[NUM_BALLS_ON_SCREEN]; // one per target on screen
+    CameraSettings camera;      // at the start of the round, the inputs replay from here
+    ReactionInput *inputs;
+    int inputCount;
+    int inputCapacity;
+    AimSummary *summaries;
+    int summaryCount;
+    int summaryCapacity;
+    // for the end screen, filled in when the round ends
+    float averageOvershoot;
+    float averageSubmovements;
+    float averageFirstStop;
+    float averageEfficiency;
+    bool statsReady;            // the averages and savedPath are for the round that just ended
+    char savedPath[560];        // the last two rounds written, the end screen replays one against the other
+    char previousPath[560];
+}ReactionSession;
+// the end of a round as handed to the job system
+typedef struct{
+    SessionHeader header;
+    AimSummary *summaries;
+    ReactionInput *inputs;
+    char path[560];
+    bool saved;
+    float averageOvershoot;
+    float averageSubmovements;
+    float averageFirstStop;
+    float averageEfficiency;
+}AimSessionJob;
+// everything a replay needs to continue from a frame, the structs are plain values so a copy is a snapshot
+typedef struct{
+    int frame;                  // inputs applied so far
+    float time;
+    ReactionGame game;
+    CameraSettings camera;
+    Camera view;
+}ReactionSnapshot;
+typedef struct{
+    MappedFile file;
+    SessionHeader header;
+    const ReactionInput *inputs;
+    ReactionSnapshot *keyframes; // one every REPLAY_KEYFRAME_SECONDS, the first is the round start
+    int keyframeCount;
+    float length;               // seconds of input in the file
+    ReactionSnapshot state;
+}SessionReplay;
+typedef struct{
+    SessionReplay replay;
+    SessionReplay ghost;        // optional second session, only its crosshair is drawn
+    bool showGhost;
+    float time;
+    int speedIndex;
+    bool paused;
+    Rectangle timeline;
+    AppState returnState;
+    ReactionSnapshot live;      // the drill's own state while the replay borrows the globals
+}ReplayViewer;
+typedef struct{
+    int width;                  // window size the cached menu layouts were built for
+    int height;
+}UiLayout;
+// on-disk layout of the text atlas cache, followed by the glyphs and the distance field
+typedef struct{
+    unsigned int magic;
+    unsigned int headerSize;
+    int scale;
+    int spread;
+    int glyphCount;
+    int width;
+    int height;
+}UiFontHeader;
+typedef struct{
+    int value;
+    int offsetX;
+    int offsetY;
+    int advanceX;
+    Rectangle source;
+}UiFontGlyph;
+typedef struct{
+    Rectangle dest;
+    Rectangle source;
+    Color color;
+}UiTextQuad;
+typedef struct{
+    bool ready;
+    Font font;                  // the default font's metrics scaled by UI_FONT_SCALE, the atlas holds distances
+    Shader shader;
+    UiTextQuad *quads;          // everything drawn this frame, flushed in one draw on top
+    int quadCount;
+    int quadCapacity;
+}UiText;
+typedef void (*ParallelTask)(void *ctx, int index);
+typedef void (*JobFunction)(void *data);
+typedef struct Job{
+    JobFunction run;            // on a worker
+    JobFunction complete;       // on the main thread, from PollJobs
+    void *data;
+    struct Job *next;
+}Job;
+typedef struct{
+    ParallelTask task;
+    void *ctx;
+    int count;
+    atomic_int next;
+    atomic_int done;
+    atomic_int refs;            // the caller and every helper job, whoever lets go last frees it
+}ParallelJob;
+// a deque per worker, the owner works one end and everyone else steals from the other
+typedef struct{
+    Job *jobs[JOB_DEQUE_SIZE];
+    int top;
+    int bottom;
+    atomic_ullong busyNanos;
+#if !defined(PLATFORM_WEB)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    bool started;
+#endif
+}JobWorker;
+typedef struct{
+    JobWorker workers[DECODE_MAX_THREADS];
+    int workerCount;            // 0 runs every job in SubmitJob, as the web build always does
+    int nextWorker;
+    atomic_int queued;          // in a deque, not picked up yet
+    atomic_int running;
+    atomic_uint steals;
+    atomic_uint submitted;
+    atomic_bool quit;
+    _Atomic(Job *) finished;    // run and waiting for the main thread, newest first
+    Job *completions;           // taken off finished in order, what the frame budget didn't get to
+    Job *completionTail;
+    int completionCount;
+    unsigned int completed;
+    double sampleTime;
+    unsigned long long sampleBusy;
+    float utilization;
+#if !defined(PLATFORM_WEB)
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wake;
+#endif
+}JobSystem;
+typedef struct{
+    int maxWidth;
+    int maxHeight;
+    Image image;
+    char path[];
+}BackgroundLoadJob;
+typedef enum{
+    EVENT_ROUND_START,
+    EVENT_SPAWN,
+    EVENT_HIT,
+    EVENT_MISS,
+    EVENT_ROUND_END,
+    EVENT_TYPE_COUNT
+}ReactionEventType;
+typedef struct{
+    long long round;            // unix time the round started, the session file's name
+    float time;                 // seconds into the round
+    unsigned char type;         // ReactionEventType
+    signed char slot;           // target on screen, -1 for round events
+    unsigned char part;         // HitboxPart of a humanoid hit
+    unsigned char humanoid;
+    float yaw;                  // crosshair
+    float pitch;
+    Vector3 position;           // of the target
+    float size;                 // target radius, humanoids are scaled by HUMANOID_SCALE on top
+    float reaction;             // seconds the target had been up
+    int value;                  // seed at round start, score at round end, otherwise the click it belongs to counted from 1, 0 for the first spawns
+}ReactionEvent;
+typedef struct{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int headerSize;
+    unsigned int eventSize;
+}EventLogHeader;
+typedef struct{
+    unsigned int magic;
+    unsigned int count;
+    unsigned int checksum;      // of the events, a batch a crash cut short fails it
+    unsigned int reserved;
+}EventBatchHeader;
+#if defined(HAVE_IO_URING)
+typedef struct{
+    int fd;
+    unsigned int *sqTail;
+    unsigned int *sqMask;
+    unsigned int *sqArray;
+    unsigned int *cqHead;
+    unsigned int *cqTail;
+    unsigned int *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sqMap;
+    void *cqMap;                // the same mapping as sqMap on kernels with IORING_FEAT_SINGLE_MMAP
+    size_t sqMapSize;
+    size_t cqMapSize;
+    size_t sqesSize;
+}EventRing;
+#endif
+typedef struct{
+    bool running;
+    ReactionEvent queue[EVENT_QUEUE_SIZE];
+    atomic_uint head;           // only the game thread moves it
+    atomic_uint tail;           // only the writer
+    atomic_uint dropped;        // the queue was full
+    atomic_uint written;        // events on disk and fsynced
+    atomic_uint commits;
+    atomic_uint failed;         // events in batches that couldn't be written
+    atomic_int commitMicros;    // write and fsync of the last batch
+    atomic_bool uring;          // io_uring, otherwise pwrite and fdatasync on the writer thread
+    atomic_bool quit;
+    float spawnTime[NUM_BALLS_ON_SCREEN]; // round time each target came up, game thread only
+#if !defined(PLATFORM_WEB)
+    pthread_t thread;
+    pthread_mutex_t lock;       // only the writer's sleep and the shutdown take it, never the game thread
+    pthread_cond_t wake;
+    int fd;
+    long long offset;           // end of the last whole batch
+    unsigned char *batch;       // batch header and up to a full queue of events
+#endif
+#if defined(HAVE_IO_URING)
+    EventRing ring;
+#endif
+}EventLog;
+typedef struct{
+    unsigned short fast[1 << INFLATE_FAST_BITS];
+    int firstCode[16];
+    int firstSymbol[16];
+    int maxCode[17];
+    unsigned char length[288];
+    unsigned short symbol[288];
+}InflateHuffman;
+typedef struct{
+    const unsigned char *in;
+    const unsigned char *inEnd;
+    unsigned long long bits;
+    int bitCount;
+    int overread;
+    unsigned char *out;
+    unsigned char *outStart;
+    unsigned char *outEnd;
+    atomic_size_t *progress;
+    atomic_int done;
+    bool ok;
+}Inflater;
+typedef struct{
+    Inflater z;
+    atomic_size_t progress;         // raw bytes inflate has published
+    unsigned char *raw;             // filtered rows straight out of inflate
+    unsigned char *pixels;
+    unsigned char *scratch;
+    const unsigned int *palette;
+    size_t rowBytes;
+    int width;
+    int height;
+    int channels;
+    int colorType;
+    bool ok;
+}PngDecode;
+typedef struct{
+    unsigned short fast[1 << JPEG_FAST_BITS];
+    int maxCode[17];
+    int offset[17];
+    unsigned char symbols[256];
+}JpegHuffman;
+typedef struct{
+    const unsigned char *in;
+    const unsigned char *end;
+    unsigned long long buffer;
+    int count;
+    bool error;
+}JpegBits;
+typedef struct{
+    const unsigned char *start;
+    const unsigned char *end;
+}JpegSegment;
+typedef struct{
+    int id;
+    int h;
+    int v;
+    int quantTable;
+    int dcTable;
+    int acTable;
+    unsigned char *plane;
+    int stride;
+    int columns;
+    int rows;
+    int *columnTaps;
+}JpegComponent;
+typedef struct{
+    int width;
+    int height;
+    int componentCount;
+    int hMax;
+    int vMax;
+    int mcusX;
+    int mcusY;
+    int mcuCount;
+    int restartInterval;
+    unsigned short quant[4][64];
+    JpegHuffman huffman[8];
+    JpegComponent components[3];
+    JpegSegment *segments;
+    int segmentCount;
+    int intervalsPerTask;
+    unsigned char *pixels;
+    atomic_int failed;
+}JpegDecoder;
+typedef struct{
+    double processStart;
+    double firstFrameTime;
+    bool firstFramePresented;
+    bool deferredInitDone;
+}StartupInfo;
+typedef enum{
+    LIVE_IDLE,
+    LIVE_CAPTURING,
+    LIVE_READY,
+    LIVE_FAILED
+}LiveCaptureState;
+typedef enum{
+    BG_COMPRESS_IDLE,
+    BG_COMPRESS_BUSY,
+    BG_COMPRESS_DONE
+}BackgroundCompressState;
+// header of a file in the background library, the RGBA pixels or BC1 blocks follow
+typedef struct{
+    unsigned int magic;
+    unsigned int headerSize;
+    int width;
+    int height;
+    int dataWidth;                  // BC1 data is padded to whole blocks
+    int dataHeight;
+    int format;
+    unsigned int size;
+}BgFileHeader;
+typedef struct{
+    bool enabled;
+    bool unsupported;               // the GPU refused BC1 once, stop encoding
+    atomic_int state;
+    unsigned long long jobHash;
+    Image result;                   // empty when the encode failed
+    int width;
+    int height;
+}BackgroundCompression;
+typedef struct{
+    unsigned long long hash;
+    Texture2D texture;              // id 0 while not on the GPU
+    int width;                      // BC1 textures are padded past this
+    int height;
+    unsigned int lastUsed;
+    bool hasBc1;                    // a compressed copy sits next to the pixels
+    bool encodeTried;
+    bool missing;
+    bool memoryOnly;                // the save failed, only the texture has the pixels
+}BgLibraryEntry;
+typedef struct{
+    char directory[512];
+    BgLibraryEntry entries[BG_LIBRARY_SLOTS];
+    int count;
+    int current;                    // -1 without any background
+    unsigned int useClock;
+    size_t vramBudget;
+    bool warming;                   // a warm up read is out on the job system
+}BackgroundLibrary;
+typedef struct{
+    unsigned long long hash;
+    bool compressed;
+    bool ok;
+    BgFileHeader header;
+    Image image;                    // owned copy, the mapping is gone by the time it uploads
+}LibraryWarmJob;
+typedef struct{
+    unsigned int drawCalls;
+    unsigned int vertices;          // indices for indexed draws
+    unsigned int textureBinds;
+    unsigned int flushes;
+    unsigned int overflows;
+    unsigned long long uploadBytes;
+    unsigned int targetsTested;     // spheres given to the frustum cull
+    unsigned int targetsDrawn;
+    unsigned int targetsPerLod[SPHERE_LOD_LEVELS];
+}RenderCounters;
+// planes face inwards, a point is inside when n.p + d >= 0 for all six
+typedef struct{
+    float nx[6], ny[6], nz[6], d[6];
+    Vector3 position;
+    Vector3 forward;
+}ViewFrustum;
+typedef struct{
+    float depth;                // along the view direction
+    int index;
+}CullEntry;
+// unit sphere triangle lists, a level per tessellation
+typedef struct{
+    Vector3 *vertices;
+    int vertexCount;
+}SphereLod;
+typedef struct{
+    bool enabled;
+    bool depthSort;             // submit front to back so the depth test throws away hidden fragments early
+    CullEntry *entries;
+    int capacity;
+    SphereLod lods[SPHERE_LOD_LEVELS];
+    unsigned char drillLod[NUM_BALLS_ON_SCREEN]; // level each drill slot was drawn at last frame
+}TargetCulling;
+typedef struct{
+    bool installed;
+    bool showOverlay;
+    RenderCounters current;
+    RenderCounters last;
+    rlRenderBatch batch;
+    unsigned int arrayBuffer;
+    unsigned int frame;
+    FILE *log;
+}RenderStats;
+typedef enum{
+    GPU_MARK_FRAME_START,
+    GPU_MARK_BACKGROUND_END,
+    GPU_MARK_SCENE_START,
+    GPU_MARK_SCENE_END,
+    GPU_MARK_FRAME_END,
+    GPU_MARK_COUNT
+}GpuTimerMark;
+typedef struct{
+    bool supported;
+    bool enabled;
+    unsigned int queries[GPU_TIMER_FRAMES][GPU_MARK_COUNT];
+    unsigned int issued[GPU_TIMER_FRAMES];      // bit per mark written in that frame
+    unsigned int frameOfSlot[GPU_TIMER_FRAMES];
+    bool pending[GPU_TIMER_FRAMES];
+    int slot;
+    unsigned int frame;
+    unsigned int dropped;
+    float backgroundMs;
+    float sceneMs;
+    float hudMs;
+    float lastSceneMs;          // newest frame that drew the 3D layer, unsmoothed for the scale controller
+    float lastOtherMs;          // background and HUD of that frame
+    bool sceneSampled;          // set on read back, cleared once the scale has used it
+    FILE *log;
+}GpuTimers;
+// what the rays said about a click, kept until the ID buffer's answer comes back
+typedef struct{
+    void *fence;                // GLsync, signalled once the pixel is in the pack buffer
+    unsigned int frame;
+    int hits;
+    unsigned char parts[NUM_BALLS_ON_SCREEN];
+    bool humanoid;
+}GpuPickRequest;
+typedef struct{
+    bool supported;
+    bool enabled;
+    Shader shader;
+    unsigned int framebuffer;
+    unsigned int texture;       // GL_R32UI, 0 where nothing was drawn
+    unsigned int buffers[GPU_PICK_READBACKS];
+    GpuPickRequest pending[GPU_PICK_READBACKS];
+    int next;
+    unsigned int checked;
+    unsigned int agreed;
+    unsigned int dropped;
+    unsigned int latency;       // frames between the click and its answer
+}GpuPicking;
+typedef struct{
+    bool enabled;
+    unsigned long window;       // X window to capture, 0 captures region of the screen
+    Rectangle region;           // empty for the whole screen
+    Texture2D texture;
+    unsigned int pbo[2];
+    int pboIndex;
+    bool hasFrame;
+    double nextCapture;
+    double interval;
+    float captureSeconds;
+    float captureCpuSeconds;
+    float cpuPercent;
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    atomic_int state;
+    atomic_bool quit;
+    unsigned char *target;      // mapped unpack buffer the capture thread writes into
+    int targetWidth;
+    int targetHeight;
+    int capturedWidth;
+    int capturedHeight;
+#endif
+}LiveBackground;
+typedef struct{
+    const char *name;
+    AppState appState;
+    GameState gameState;
+    int targets;                // spheres in the 3D layer, the game's own included
+    int bgWidth;
+    int bgHeight;
+    MotionPattern motion;       // of the extra targets
+}BenchScene;
+typedef struct{
+    bool enabled;
+    bool running;
+    const char *reportPath;
+    int frames;
+    float *targetX;             // drawn next to the game's own spheres
+    float *targetY;
+    float *targetZ;
+    float *movedX;              // targetX/Y plus the motion offsets in moving scenes
+    float *movedY;
+    unsigned char *lod;
+    int targetCount;
+    TargetMotion motion;        // offsets of the extra targets in moving scenes
+    double *gpuMs;              // filled in as the timestamp queries come back, a few frames late
+    int gpuCount;
+    unsigned int gpuFirstFrame; // GPU frames before this belong to warmup
+    unsigned int gpuEndFrame;
+}Benchmark;
 #pragma endregion
 #pragma region Forward Functions
 void UpdateGame();
 void UpdateAndDrawApp();
 void UpdateGame();
-void UpdateMainMenu();
+void UpdateLayout();
+void LayoutMainMenu();
 void DrawMainMenu();
 void ResetReactionGame();
+void BeginAimSession();
+void RestartAimTrackers(unsigned int slots);
+void UpdateAimSession();
+void RecordAimClick(int slot, bool hit);
+int FindNearestAimTarget();
+void EndAimSession();
 void UpdateReactionGame();
 void UpdateReactionGameState();
 void DrawReactionGame();
 void DrawReactionStartMenu();
 void UpdateReactionStartMenu();
+void LayoutReactionStartMenu();
 void RenderReactinGameState();
 void ReactionGameCheckForHide();
 void DrawReactionGameEnd();
 void UpdateReactionGameEnd();
-bool IsInActiveArray(int value);
-int GetRandomBall();
-void PickRandomStartBalls();
-void PickRandomStartBalls();
+bool IsInActiveArray(const ReactionGame *game, int value);
+int GetRandomBall(ReactionGame *game);
+void PickRandomStartBalls(ReactionGame *game);
+void InitReactionRound(ReactionGame *game, unsigned int seed);
+void StepReactionGame(ReactionGame *game, CameraSettings *cam, Camera *view, float sensitivity, ReactionInput input);
+int FindReactionHits(const ReactionGame *game, const Camera *view, unsigned char *parts);
+void ApplyReactionClick(ReactionGame *game, int hits, const unsigned char *parts);
+void PushRollingStats(RollingStats *stats, bool hit, float reaction);
+float GetRollingPercentile(const RollingStats *stats, float fraction);
+void UpdateAdaptiveDifficulty(ReactionGame *game);
+unsigned int NextRandom(unsigned int *state);
+void SpawnTargetMotion(TargetMotion *motion, int lane, MotionPattern pattern, unsigned int *random);
+void StepTargetMotion(TargetMotion *motion);
+TargetMotion GetReactionMotion(ReactionGame *game);
+void SpawnReactionTarget(ReactionGame *game, int slot);
+Vector3 GetReactionTarget(const ReactionGame *game, int slot);
+void RecordReactionInput(ReactionInput input);
+int RunSessionResim(const char *directory, ReactionRules rules);
+bool CheckSessionFile(const MappedFile *file, SessionHeader *header, const ReactionInput **inputs);
+ReactionSnapshot BeginReactionSnapshot(const SessionHeader *header, ReactionRules rules);
+void StepReactionSnapshot(ReactionSnapshot *snapshot, const SessionHeader *header, ReactionInput input);
+bool LoadSessionReplay(SessionReplay *replay, const char *path);
+void UnloadSessionReplay(SessionReplay *replay);
+void SeekSessionReplay(SessionReplay *replay, float time);
+bool StartReplayViewer(const char *path, const char *ghostPath);
+void StopReplayViewer();
+void LayoutReplayViewer();
+void UpdateReplayViewer();
+void DrawReplayViewer();
 void UpdateTrackGame();
 void DrawTrackGame();
+void GetBackgroundLimit(int *maxWidth, int *maxHeight);
+void FitBackgroundImage(Image *image, int maxWidth, int maxHeight);
+void LoadBackgroundJob(void *data);
+void LoadClipboardJob(void *data);
+void AddBackgroundJob(void *data);
+void UpdateSceneScale();
+void BeginSceneLayer();
+void EndSceneLayer();
+double ClockSeconds();
+void DeferredInit();
+void LoadUiText();
+void UnloadUiText();
+void DrawUiText(const char *text, int posX, int posY, int fontSize, Color color);
+void FlushUiText();
+MappedFile MapFile(const char *path);
+void UnmapFile(MappedFile *file);
+void MapProfile();
+void UnmapProfile();
+void LoadProfile();
+void SaveProfile();
+int GetWorkerCount();
+void ParallelFor(int count, ParallelTask task, void *ctx);
+void InitJobSystem();
+void SubmitJob(JobFunction run, JobFunction complete, void *data);
+void PollJobs(double budget);
+void ShutdownJobSystem();
+void DrawJobStats();
+unsigned int ChecksumEvents(const ReactionEvent *events, int count);
+long long FindEventLogEnd(const unsigned char *data, long long size);
+void StartEventLog();
+void StopEventLog();
+void LogReactionEvent(ReactionEvent event);
+void LogRoundEvent(ReactionEventType type);
+void LogClickEvents(int hits, const unsigned char *parts);
+void LogSpawnEvents(int hits);
+void DrawEventLogStats();
+int RunEventExport(const char *outPath, const char *source);
+bool InflateZlib(Inflater *z);
+void UnfilterPngRow(int filter, unsigned char *cur, const unsigned char *raw, const unsigned char *prev, int rowBytes, int bpp);
+bool DecodePngFast(const unsigned char *data, int size, Image *image);
+bool DecodeJpegFast(const unsigned char *data, int size, Image *image);
+Image LoadImageFromMemoryFast(const char *fileType, const unsigned char *data, int size);
+Image LoadBackgroundImage(const char *fileName);
+int RunDecodeBenchmark(const char *directory, int iterations);
+void InitHumanoidHitbox();
+int RaycastHumanoid(Ray ray, Vector3 position, float scale, float padding);
+int RunHitboxBenchmark(int humanoids);
+bool DecodeBmpToRgba(const unsigned char *data, int size, Image *image);
+Image LoadClipboardImage();
+unsigned long long HashPixels(Image image);
+Image EncodeBc1(Image source);
+bool UseCompressedBackgrounds();
+void UpdateBackgroundCompression();
+void SetBackgroundCompression(bool enabled);
+void StopBackgroundCompression();
+void GetBgFilePath(unsigned long long hash, const char *extension, char *path, int size);
+bool SaveBgFile(unsigned long long hash, const char *extension, Image image, int width, int height);
+bool ReadBgFileHeader(unsigned long long hash, const char *extension, BgFileHeader *header);
+bool MapBgFile(unsigned long long hash, const char *extension, MappedFile *file, Image *image, BgFileHeader *header);
+int FindLibraryEntry(unsigned long long hash);
+size_t GetLibraryVram();
+void SetLibraryTexture(int index, Texture2D texture);
+bool LoadLibraryTexture(int index);
+void SelectLibraryEntry(int index);
+void AddLibraryBackground(Image image);
+void LoadBackgroundLibrary();
+void ReadLibraryJob(void *data);
+void UploadLibraryJob(void *data);
+void UpdateBackgroundLibrary();
+void UnloadBackgroundLibrary();
+void InstallRenderStats();
+void UninstallRenderStats();
+void OpenRenderStatsLog(const char *fileName);
+void EndRenderStatsFrame();
+void DrawRenderStats();
+void InitGpuTimers();
+void UnloadGpuTimers();
+void OpenGpuTimerLog(const char *fileName);
+void BeginGpuFrame();
+void MarkGpuTimer(GpuTimerMark mark);
+void EndGpuFrame();
+void SetGpuTimersEnabled(bool enabled);
+void DrawGpuTimers();
+ViewFrustum GetViewFrustum(Camera camera, float aspect);
+int CullSpheres(const ViewFrustum *frustum, const float *x, const float *y, const float *z, int count, float radius, CullEntry *visible);
+bool InitGpuPicking();
+void UnloadGpuPicking();
+void SetGpuPickingEnabled(bool enabled);
+void RequestGpuPick(const ReactionGame *game, const Camera *view);
+void UpdateGpuPicking();
+void DrawGpuPicking();
+void InitSphereLods();
+void UnloadSphereLods();
+int SelectSphereLod(float pixelRadius, int previous);
+void DrawTargetSpheres(const float *x, const float *y, const float *z, unsigned char *lod, int count, float radius, Color color);
+void DrawTargetHumanoids(const float *x, const float *y, const float *z, unsigned char *lod, int count, float scale, Color color);
+void StartLiveBackground();
+void StopLiveBackground();
+void UpdateLiveBackground();
+void DrawLiveBackgroundStats();
+int RunBenchmark();
+void DrawBenchTargets();
 
 #pragma endregion
 #pragma region Globals
@@ -121,6 +1224,24 @@ Camera camera;
 ReactionGame reactionGame;
 ReactionGameStartMenu reactionStart;
 BackgroundImage bgImage;
+Profile profile;
+StartupInfo startup;
+SceneLayer sceneLayer = { .scale = 1.0f };
+UiText uiText;
+UiLayout uiLayout;
+ReactionSession session;
+ReplayViewer replayViewer;
+LiveBackground liveBg;
+BackgroundCompression bgCompress;
+RenderStats renderStats;
+GpuTimers gpuTimers;
+GpuPicking picking;
+JobSystem jobs;
+EventLog eventLog;
+TargetCulling culling = { .enabled = true };
+HumanoidHitbox humanoidHitbox;
+Benchmark bench = { .reportPath = BENCH_REPORT_FILE, .frames = BENCH_FRAMES };
+BackgroundLibrary library = { .current = -1, .vramBudget = BG_LIBRARY_VRAM_BUDGET };
 
 int screenWidth = 1280;
 int screenHeight = 800;
@@ -131,23 +1252,100 @@ struct Color ballColors[] = {RED,GREEN,BLUE,PINK,PURPLE,ORANGE,YELLOW,BLACK,WHIT
 #pragma endregion
 #pragma region Main
 //gcc main.c  -L lib/ -framework CoreVideo -framework IOKit -framework Cocoa -framework GLUT -framework OpenGL lib/libraylib.a -o Incognitoaim
+//linux: gcc main.c -Iinclude -Llib -lraylib -lGL -lm -lpthread -ldl -lrt -lX11 -lXext -lXcomposite -o Incognitoaim
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+__attribute__((constructor)) static void StampProcessStart()
+{
+    // runs before main so the first frame metric covers static init and the loader as well
+    startup.processStart = ClockSeconds();
+}
+int main(int argc, char **argv)
 {
     // Initialization
     //--------------------------------------------------------------------------------------
+    InitHumanoidHitbox();
+    // headless tools
+    if (argc > 1 && strcmp(argv[1], "--hitbox-bench") == 0)
+        return RunHitboxBenchmark(argc > 2 ? atoi(argv[2]) : 32);
+    if (argc > 2 && strcmp(argv[1], "--decode-bench") == 0)
+    {
+        // the decoders split their work over the same workers the game uses
+        InitJobSystem();
+        int result = RunDecodeBenchmark(argv[2], argc > 3 ? atoi(argv[3]) : 5);
+        ShutdownJobSystem();
+        return result;
+    }
+    if (argc > 2 && strcmp(argv[1], "--resim") == 0)
+    {
+        ReactionRules rules = { .hitPadding = REACTION_HIT_PADDING, .ballSpacing = REACTION_BALL_SPACING, .hitScore = 1 };
+        for (int i = 3; i + 1 < argc; i++)
+        {
+            if (strcmp(argv[i], "--hit-padding") == 0) rules.hitPadding = atof(argv[++i]);
+            else if (strcmp(argv[i], "--ball-spacing") == 0) rules.ballSpacing = atof(argv[++i]);
+            else if (strcmp(argv[i], "--hit-score") == 0) rules.hitScore = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--adaptive") == 0) rules.adaptive = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--motion") == 0) rules.motion = Clamp(atoi(argv[++i]), 0, MOTION_PATTERN_COUNT - 1);
+            else if (strcmp(argv[i], "--humanoid") == 0) rules.humanoid = atoi(argv[++i]);
+        }
+        InitJobSystem();
+        int result = RunSessionResim(argv[2], rules);
+        ShutdownJobSystem();
+        return result;
+    }
+    if (argc > 2 && strcmp(argv[1], "--export-events") == 0)
+        return RunEventExport(argv[2], argc > 3 ? argv[3] : NULL);
+    bool startLive = false;
+    const char *replayPath = NULL;
+    const char *ghostPath = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--live") == 0) startLive = true;
+        else if (strcmp(argv[i], "--live-window") == 0 && i + 1 < argc)
+        {
+            liveBg.window = strtoul(argv[++i], NULL, 0);
+            startLive = true;
+        }
+        else if (strcmp(argv[i], "--live-region") == 0 && i + 1 < argc)
+        {
+            Rectangle *r = &liveBg.region;
+            if (sscanf(argv[++i], "%f,%f,%f,%f", &r->x, &r->y, &r->width, &r->height) != 4) *r = (Rectangle){ 0 };
+            startLive = true;
+        }
+        else if (strcmp(argv[i], "--stats") == 0) renderStats.showOverlay = true;
+        else if (strcmp(argv[i], "--no-cull") == 0) culling.enabled = false;
+        else if (strcmp(argv[i], "--depth-sort") == 0) culling.depthSort = true;
+        else if (strcmp(argv[i], "--gpu-pick") == 0) picking.enabled = true;
+        else if (strcmp(argv[i], "--render-log") == 0 && i + 1 < argc) OpenRenderStatsLog(argv[++i]);
+        else if (strcmp(argv[i], "--gpu-times") == 0) gpuTimers.enabled = true;
+        else if (strcmp(argv[i], "--gpu-log") == 0 && i + 1 < argc) OpenGpuTimerLog(argv[++i]);
+        else if (strcmp(argv[i], "--bench") == 0)
+        {
+            bench.enabled = true;
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) bench.reportPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bench-frames") == 0 && i + 1 < argc) bench.frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--ghost") == 0 && i + 1 < argc) ghostPath = argv[++i];
+    }
+
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);// |  FLAG_WINDOW_UNDECORATED);
     
     InitWindow(screenWidth, screenHeight, "IncognitoAim");
+    InstallRenderStats();
+    InitGpuTimers();
+    InitJobSystem();
+    if (picking.enabled) SetGpuPickingEnabled(true);
 
     game = (Game){ REACTION, START, 0};
     mainMenuData = (MainMenuData){ {0,0}};
     reactionStart = (ReactionGameStartMenu){};
     reactionStart.mouseSensitivity = 2.;
+    reactionStart.ballSize = 1;
     reactionGame.ballSize = 1;
     reactionGame.hideGame = false;
+    reactionGame.rules = (ReactionRules){ .hitPadding = REACTION_HIT_PADDING, .ballSpacing = REACTION_BALL_SPACING, .hitScore = 1 };
     camSettings.sensitivity = 0.001f;
     //camSettings.sensitivity = 0.001f;
     camSettings.pitch = 0.0f;  // Up/Down angle
@@ -164,6 +1362,15 @@ int main(void)
     bgImage.bg_pos = (Vector2){0.0f,0.0f};
     bgImage.image_loaded = false;
 
+    // saved settings and the last background override the defaults above, benchmarks always run on the defaults
+    if (!bench.enabled)
+    {
+        LoadProfile();
+        LoadBackgroundLibrary();
+        StartEventLog();
+        if (startLive) StartLiveBackground();
+        if (replayPath != NULL) StartReplayViewer(replayPath, ghostPath);
+    }
 
     int isCursorHidden = 0;
 
@@ -176,19 +1383,41 @@ int main(void)
     #else
     //--------------------------------------------------------------------------------------
 
+    int exitCode = 0;
+    if (bench.enabled) exitCode = RunBenchmark();
+
     // Main game loop
-    while (!WindowShouldClose())    // Detect window close button or ESC key
+    while (!bench.enabled && !WindowShouldClose())    // Detect window close button or ESC key
     {
         UpdateGame();
     }
     #endif
     // De-Initialization
     //--------------------------------------------------------------------------------------
-    UnloadTexture(bgImage.bg_texture);
+    // a round or background still in flight finishes first
+    ShutdownJobSystem();
+    StopEventLog();
+    // the profile is only a header, the background in use can change at any time
+    if (!bench.enabled) SaveProfile();
+    UnmapProfile();
+    StopReplayViewer();
+    StopLiveBackground();
+    StopBackgroundCompression();
+    if (sceneLayer.target.id > 0) UnloadRenderTexture(sceneLayer.target);
+    UnloadBackgroundLibrary();
+    UnloadGpuTimers();
+    UnloadGpuPicking();
+    UninstallRenderStats();
+    UnloadUiText();
+    UnloadSphereLods();
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
     
+    #if defined(PLATFORM_WEB)
     return 0;
+    #else
+    return exitCode;
+    #endif
 }
 void UpdateGame()
 {
@@ -202,405 +1431,6590 @@ void UpdateGame()
     //if(IsKeyPressed(KEY_P)){
      //ToggleFullscreen();         
     //}
-    bgImage.bg_dest_rect.width = screenWidth;
-    bgImage.bg_dest_rect.height = screenHeight;
+    UpdateLayout();
+    UpdateSceneScale();
+    PollJobs(JOB_FRAME_BUDGET);
     
     //check if file is dropped and load it to background
     if (IsFileDropped()) {
         FilePathList droppedFiles = LoadDroppedFiles();
         if (droppedFiles.count > 0) {
-            // Load the first dropped file as a texture
-            if (bgImage.image_loaded) UnloadTexture(bgImage.bg_texture);  // Unload previous texture
-            Image image = LoadImage(droppedFiles.paths[0]);
-            bgImage.bg_texture = LoadTextureFromImage(image);
-            bgImage.bg_source_rect.width = bgImage.bg_texture.width;
-            bgImage.bg_source_rect.height = bgImage.bg_texture.height;
-            UnloadImage(image);
-            bgImage.image_loaded = true;
-    
+            // Load the first dropped file as a texture, decoded and resized on the job system
+            const char *path = droppedFiles.paths[0];
+            BackgroundLoadJob *job = malloc(sizeof(BackgroundLoadJob) + strlen(path) + 1);
+            job->image = (Image){ 0 };
+            GetBackgroundLimit(&job->maxWidth, &job->maxHeight);
+            strcpy(job->path, path);
+            SubmitJob(LoadBackgroundJob, AddBackgroundJob, job);
         }
         UnloadDroppedFiles(droppedFiles);
     }
+    //paste a background straight from the clipboard, nothing touches the disk
+    bool pasteModifier = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL) || IsKeyDown(KEY_LEFT_SUPER) || IsKeyDown(KEY_RIGHT_SUPER);
+    if (pasteModifier && IsKeyPressed(KEY_V))
+    {
+        // the selection transfer can wait on the owner for a second, it and the decode run on the job system like a drop
+        BackgroundLoadJob *job = calloc(1, sizeof(BackgroundLoadJob) + 1);
+        GetBackgroundLimit(&job->maxWidth, &job->maxHeight);
+#if !defined(__linux__) || defined(PLATFORM_WEB)
+        // raylib's clipboard belongs to the main thread, only the resize moves off it
+        job->image = LoadClipboardImage();
+#endif
+        SubmitJob(LoadClipboardJob, AddBackgroundJob, job);
+    }
+    //mirror another window or the screen behind the game instead of a still
+    if (IsKeyPressed(KEY_F8))
+    {
+        if (liveBg.enabled) StopLiveBackground();
+        else StartLiveBackground();
+    }
+    if (IsKeyPressed(KEY_F5)) SetGpuPickingEnabled(!picking.enabled);
+    if (IsKeyPressed(KEY_F6)) culling.depthSort = !culling.depthSort;
+    if (IsKeyPressed(KEY_F7)) culling.enabled = !culling.enabled;
+    if (IsKeyPressed(KEY_F9)) renderStats.showOverlay = !renderStats.showOverlay;
+    if (IsKeyPressed(KEY_F10)) SetGpuTimersEnabled(!gpuTimers.enabled);
+    UpdateGpuPicking();
+    UpdateLiveBackground();
+    UpdateBackgroundLibrary();
+    UpdateBackgroundCompression();
     //Render
+    BeginGpuFrame();
     BeginDrawing();
+        MarkGpuTimer(GPU_MARK_FRAME_START);
     
         ClearBackground(DARKGRAY);
     
-         if (bgImage.image_loaded) {
+        if (liveBg.hasFrame) {
+            DrawTexturePro(liveBg.texture, (Rectangle){ 0, 0, liveBg.texture.width, liveBg.texture.height }, bgImage.bg_dest_rect, bgImage.bg_pos, 0.0f, WHITE);
+        } else if (bgImage.image_loaded) {
             DrawTexturePro(bgImage.bg_texture, bgImage.bg_source_rect,bgImage.bg_dest_rect,bgImage.bg_pos,0.0f, WHITE);  // Draw image at (200,150)
         } else {
-            DrawText("Drop an image file here", screenWidth * .4, screenHeight  *.05, 20, BLACK);
+            DrawUiText("Drop an image file here", screenWidth * .4, screenHeight  *.05, 20, BLACK);
         }
-        UpdateAndDrawApp();
+        MarkGpuTimer(GPU_MARK_BACKGROUND_END);
+        // the first frame only shows the background so the window looks like the work app as soon as possible
+        if (startup.firstFramePresented) UpdateAndDrawApp();
+        DrawLiveBackgroundStats();
+        DrawRenderStats();
+        DrawGpuTimers();
+        DrawGpuPicking();
+        DrawJobStats();
+        DrawEventLogStats();
+        FlushUiText();
+        EndGpuFrame();
     
         // DrawRectangle(0,0,250,54,BLACK);
         // DrawText(TextFormat("Delta Time: %02f", dt), 4, 4, 25, RED);
         // DrawText(TextFormat("fps: %02f", fps), 4, 25, 25, RED);
     EndDrawing();
+    EndRenderStatsFrame();
+    if (!startup.firstFramePresented)
+    {
+        startup.firstFramePresented = true;
+        startup.firstFrameTime = ClockSeconds() - startup.processStart;
+        TraceLog(LOG_INFO, "STARTUP: First frame presented after %.1f ms", startup.firstFrameTime*1000.0);
+        DeferredInit();
+    }
     //----------------------------------------------------------------------------------
 }
-#pragma endregion
-#pragma region Main Loops
-void UpdateAndDrawApp()
+void GetBackgroundLimit(int *maxWidth, int *maxHeight)
 {
-    switch (game.appState)
+    // the largest window we can have
+    int monitor = GetCurrentMonitor();
+    *maxWidth = GetMonitorWidth(monitor);
+    *maxHeight = GetMonitorHeight(monitor);
+    if (*maxWidth <= 0 || *maxHeight <= 0)
     {
-    case MAIN:
-        UpdateMainMenu();
-        DrawMainMenu();
-        break;
-    case REACTION:
-        UpdateReactionGameState();
-        break;
-    case TRACK:
-        UpdateTrackGame();
-        DrawTrackGame();
-        break;
-    
-    default:
-        break;
+        *maxWidth = screenWidth;
+        *maxHeight = screenHeight;
     }
 }
-
+void FitBackgroundImage(Image *image, int maxWidth, int maxHeight)
+{
+    // no raylib window state in here, it runs on job workers
+    int width = image->width > maxWidth ? maxWidth : image->width;
+    int height = image->height > maxHeight ? maxHeight : image->height;
+    if (width != image->width || height != image->height) ImageResize(image, width, height);
+    ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+}
+void LoadBackgroundJob(void *data)
+{
+    BackgroundLoadJob *job = data;
+    job->image = LoadBackgroundImage(job->path);
+    if (job->image.data != NULL) FitBackgroundImage(&job->image, job->maxWidth, job->maxHeight);
+}
+void LoadClipboardJob(void *data)
+{
+    BackgroundLoadJob *job = data;
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    job->image = LoadClipboardImage();
+#endif
+    if (job->image.data != NULL) FitBackgroundImage(&job->image, job->maxWidth, job->maxHeight);
+}
+void AddBackgroundJob(void *data)
+{
+    // the upload and the library need the main thread
+    BackgroundLoadJob *job = data;
+    if (job->image.data != NULL)
+    {
+        AddLibraryBackground(job->image);
+        SaveProfile();
+    }
+    // a paste has no path, LoadClipboardImage already said why it came back empty
+    else if (job->path[0] != '\0') TraceLog(LOG_WARNING, "BACKGROUND: [%s] Failed to load dropped file", job->path);
+    free(job);
+}
+double ClockSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+void DeferredInit()
+{
+    // everything the first frame does not need
+    GuiLoadStyleDefault();
+    LoadUiText();
+    startup.deferredInitDone = true;
+}
 #pragma endregion
-#pragma region MainMenu
-void UpdateMainMenu()
+#pragma region Scene Layer
+void UpdateSceneScale()
 {
-    mainMenuData.pos.x = screenWidth * .35;
-    mainMenuData.pos.y = screenHeight * .35;
-    mainMenuData.fontScale = screenHeight * .05 ;
-    mainMenuData.spaccing = mainMenuData.fontScale + (mainMenuData.fontScale * .5);
-    mainMenuData.fontColor = BLACK;
-    
-    mainMenuData.reactionRect.x = mainMenuData.pos.x;
-    mainMenuData.reactionRect.y = mainMenuData.pos.y;
-    mainMenuData.reactionRect.width =  MeasureText("Reaction Practice", mainMenuData.fontScale);
-    mainMenuData.reactionRect.height = mainMenuData.fontScale;
+    // hold the monitor refresh rate, 60 when the platform can't tell us
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    sceneLayer.targetFrameTime = 1.0f / (refreshRate > 0 ? refreshRate : 60);
+    // benchmarks measure the full resolution, a moving scale would hide the cost they are after
+    if (bench.running) sceneLayer.scale = 1.0f;
+    if (dt <= 0.0f || bench.running) return;
 
-    mainMenuData.trackingRect.x = mainMenuData.pos.x;
-    mainMenuData.trackingRect.y = mainMenuData.pos.y + mainMenuData.spaccing;
-    mainMenuData.trackingRect.width = MeasureText("Tracking Practice", mainMenuData.fontScale);
-    mainMenuData.trackingRect.height = mainMenuData.fontScale;
+    // vsync blocks in the swap so dt sits on the refresh interval whatever the GPU has left, the scene pass timer sees the real cost
+    bool gpuDriven = gpuTimers.supported && gpuTimers.enabled;
+    if (gpuDriven != sceneLayer.gpuDriven) sceneLayer.smoothedFrameTime = 0.0f;
+    sceneLayer.gpuDriven = gpuDriven;
+    float frameTime = dt;
+    float budget = sceneLayer.targetFrameTime;
+    if (gpuDriven)
+    {
+        if (!gpuTimers.sceneSampled) return;
+        gpuTimers.sceneSampled = false;
+        // only the scene pass scales, the background and HUD take their share of the budget first
+        frameTime = gpuTimers.lastSceneMs*0.001f;
+        budget = fmaxf(sceneLayer.targetFrameTime*SCENE_GPU_BUDGET - gpuTimers.lastOtherMs*0.001f, sceneLayer.targetFrameTime*0.1f);
+        if (frameTime <= 0.0f) return;
+    }
+    if (sceneLayer.smoothedFrameTime <= 0.0f) sceneLayer.smoothedFrameTime = frameTime;
+    sceneLayer.smoothedFrameTime = Lerp(sceneLayer.smoothedFrameTime, frameTime, 0.1f);
+
+    // cost follows the pixel count so the scale moves with the square root of the frame time ratio
+    float ratio = budget / sceneLayer.smoothedFrameTime;
+    double now = ClockSeconds();
+    if (sceneLayer.probeInterval <= 0.0) sceneLayer.probeInterval = SCENE_PROBE_SECONDS;
+    if (fabsf(ratio - 1.0f) < SCENE_SCALE_DEADBAND)
+    {
+        // without the timers a frame that makes vsync looks the same at any scale, so step up now and then and let a miss push back
+        if (!gpuDriven && sceneLayer.scale < 1.0f && now - sceneLayer.lastProbe >= sceneLayer.probeInterval)
+        {
+            // reaching the next probe without a miss means the last one held
+            if (sceneLayer.probing) sceneLayer.probeInterval = SCENE_PROBE_SECONDS;
+            sceneLayer.scale = fminf(sceneLayer.scale + SCENE_PROBE_STEP, 1.0f);
+            sceneLayer.lastProbe = now;
+            sceneLayer.probing = true;
+        }
+        return;
+    }
+    if (sceneLayer.probing && ratio < 1.0f && now - sceneLayer.lastProbe < SCENE_PROBE_SECONDS)
+    {
+        // a probe that cost frames waits longer before the next one
+        sceneLayer.probing = false;
+        sceneLayer.probeInterval = fmin(sceneLayer.probeInterval*2.0, SCENE_PROBE_MAX_SECONDS);
+    }
+    float wanted = sceneLayer.scale * sqrtf(ratio);
+    sceneLayer.scale = Clamp(Lerp(sceneLayer.scale, wanted, SCENE_SCALE_GAIN), SCENE_MIN_SCALE, 1.0f);
 }
-void DrawMainMenu()
+void BeginSceneLayer()
 {
-    
-    //DrawRectangleRec(mainMenuData.reactionRect, RED);
-    //DrawRectangleRec(mainMenuData.trackingRect, BLUE);
-    DrawText("Reaction Practice",mainMenuData.pos.x,mainMenuData.pos.y,mainMenuData.fontScale,mainMenuData.fontColor);
-    //DrawText("Tracking Practice",mainMenuData.trackingRect.x,mainMenuData.trackingRect.y,mainMenuData.fontScale,mainMenuData.fontColor);
-    
-    if (GuiLabelButton(mainMenuData.reactionRect, ""))
+    MarkGpuTimer(GPU_MARK_SCENE_START);
+    // the texture always matches the window, lower scales only use its bottom left corner
+    if (sceneLayer.target.texture.width != screenWidth || sceneLayer.target.texture.height != screenHeight)
     {
-        game.appState = REACTION;
+        if (sceneLayer.target.id > 0) UnloadRenderTexture(sceneLayer.target);
+        sceneLayer.target = LoadRenderTexture(screenWidth, screenHeight);
+        SetTextureFilter(sceneLayer.target.texture, TEXTURE_FILTER_BILINEAR);
     }
-    // if (GuiLabelButton(mainMenuData.trackingRect, ""))
-    // {
+    sceneLayer.viewWidth = (int)(screenWidth * sceneLayer.scale);
+    sceneLayer.viewHeight = (int)(screenHeight * sceneLayer.scale);
+    if (sceneLayer.viewWidth < 1) sceneLayer.viewWidth = 1;
+    if (sceneLayer.viewHeight < 1) sceneLayer.viewHeight = 1;
 
-    // }
-    
+    BeginTextureMode(sceneLayer.target);
+    ClearBackground(BLANK);
+    rlViewport(0, 0, sceneLayer.viewWidth, sceneLayer.viewHeight);
+}
+void EndSceneLayer()
+{
+    EndTextureMode();
+    // cleared to transparent black the layer is effectively premultiplied, blending it that way keeps edges clean when upscaled
+    Rectangle source = { 0, 0, sceneLayer.viewWidth, -sceneLayer.viewHeight };
+    Rectangle dest = { 0, 0, screenWidth, screenHeight };
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTexturePro(sceneLayer.target.texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    EndBlendMode();
+    MarkGpuTimer(GPU_MARK_SCENE_END);
 }
 #pragma endregion
-#pragma region  Reaction Game
-void UpdateReactionGameState()
+#pragma region UI Text
+#if defined(PLATFORM_WEB)
+static const char *uiTextShaderCode =
+    "#version 100\n"
+    "#extension GL_OES_standard_derivatives : enable\n"
+    "precision mediump float;\n"
+    "varying vec2 fragTexCoord;\n"
+    "varying vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "void main()\n"
+    "{\n"
+    "    float distance = texture2D(texture0, fragTexCoord).r;\n"
+    "    float width = fwidth(distance);\n"
+    "    gl_FragColor = vec4(fragColor.rgb, fragColor.a*smoothstep(0.5 - width, 0.5 + width, distance))*colDiffuse;\n"
+    "}\n";
+#else
+static const char *uiTextShaderCode =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    float distance = texture(texture0, fragTexCoord).r;\n"
+    "    float width = fwidth(distance);\n"
+    "    finalColor = vec4(fragColor.rgb, fragColor.a*smoothstep(0.5 - width, 0.5 + width, distance))*colDiffuse;\n"
+    "}\n";
+#endif
+static void GetUiFontPath(char *path, int size)
 {
-    switch (reactionGame.gameState)
-    {
-    case START:
-        UpdateReactionStartMenu();
-        DrawReactionStartMenu();
-        break;
-    case PLAY:
-        UpdateReactionGame();
-        DrawReactionGame();
-        break;
-    case HIDE:
-        break;
-    case END:
-        UpdateReactionGameEnd();
-        DrawReactionGameEnd();
-        break;
-    
-    default:
-        break;
-    }
-    ReactionGameCheckForHide();
+    snprintf(path, size, "%s%s", GetApplicationDirectory(), UI_FONT_FILE_NAME);
 }
-void ReactionGameCheckForHide()
+static bool LoadUiFontCache(Font *font, Image *atlas)
 {
-    if(IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))
+    char path[512];
+    GetUiFontPath(path, sizeof(path));
+    if (!FileExists(path)) return false;
+    MappedFile file = MapFile(path);
+    if (file.data == NULL) return false;
+
+    // anything built with other settings is regenerated
+    UiFontHeader header = { 0 };
+    if (file.size >= sizeof(header)) memcpy(&header, file.data, sizeof(header));
+    size_t glyphBytes = (size_t)header.glyphCount*sizeof(UiFontGlyph);
+    bool ok = header.magic == UI_FONT_MAGIC && header.headerSize == sizeof(UiFontHeader) &&
+              header.scale == UI_FONT_SCALE && header.spread == UI_FONT_SPREAD &&
+              header.glyphCount > 0 && header.glyphCount <= 1024 && header.width > 0 && header.width <= 4096 &&
+              header.height > 0 && header.height <= 4096 &&
+              file.size == sizeof(header) + glyphBytes + (size_t)header.width*header.height;
+    if (ok)
     {
-        if(reactionGame.hideGame)
-        {
-            reactionGame.hideGame = false;
-            reactionGame.gameState = reactionGame.previousState;
-            if(reactionGame.gameState == PLAY)
-                DisableCursor();
-        }
-        else
+        const UiFontGlyph *glyphs = (const UiFontGlyph *)(file.data + sizeof(header));
+        font->baseSize = GetFontDefault().baseSize*UI_FONT_SCALE;
+        font->glyphCount = header.glyphCount;
+        font->glyphs = RL_CALLOC(header.glyphCount, sizeof(GlyphInfo));
+        font->recs = RL_MALLOC(header.glyphCount*sizeof(Rectangle));
+        for (int i = 0; i < header.glyphCount; i++)
         {
-            reactionGame.hideGame = true;
-            reactionGame.previousState = reactionGame.gameState;
-            reactionGame.gameState = HIDE;   
-            EnableCursor(); 
+            font->glyphs[i] = (GlyphInfo){ glyphs[i].value, glyphs[i].offsetX, glyphs[i].offsetY, glyphs[i].advanceX };
+            font->recs[i] = glyphs[i].source;
         }
+        *atlas = ImageCopy((Image){ file.data + sizeof(header) + glyphBytes, header.width, header.height, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE });
     }
+    else TraceLog(LOG_WARNING, "UITEXT: [%s] Ignoring stale text atlas", path);
+    UnmapFile(&file);
+    return ok;
 }
-void ResetReactionGame()
+static void SaveUiFontCache(const Font *font, Image atlas)
 {
-    int x=0;
-    int y=0;
-    for(int i=0;i<NUM_REACTION_BALLS;++i){
-        reactionGame.balls[i] = false;
-        reactionGame.ballPositions[i] = (Vector3){0,0,700};
+    char path[512];
+    char tmpPath[sizeof(path) + 8];
+    GetUiFontPath(path, sizeof(path));
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    UiFontHeader header = { .magic = UI_FONT_MAGIC, .headerSize = sizeof(UiFontHeader), .scale = UI_FONT_SCALE, .spread = UI_FONT_SPREAD,
+                            .glyphCount = font->glyphCount, .width = atlas.width, .height = atlas.height };
+    FILE *file = fopen(tmpPath, "wb");
+    bool ok = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int i = 0; ok && i < font->glyphCount; i++)
+    {
+        const GlyphInfo *glyph = &font->glyphs[i];
+        UiFontGlyph record = { .value = glyph->value, .offsetX = glyph->offsetX, .offsetY = glyph->offsetY, .advanceX = glyph->advanceX, .source = font->recs[i] };
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
     }
-    for (int i = 0; i < NUM_BALLS_ON_SCREEN; ++i)
+    ok = ok && fwrite(atlas.data, 1, (size_t)atlas.width*atlas.height, file) == (size_t)atlas.width*atlas.height;
+    if (file != NULL) ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmpPath, path) != 0)
     {
-        reactionGame.activeBallIndexs[i] = 0;
+        TraceLog(LOG_WARNING, "UITEXT: [%s] Failed to write text atlas", path);
+        remove(tmpPath);
     }
-    
-    reactionGame.score = 1;
-    reactionGame.numClicks = 1;
-    reactionGame.accuracy = 0;
-    reactionGame.timer = 30;
-    PickRandomStartBalls();
-
+}
+static bool GenerateUiFont(Font *font, Image *atlas)
+{
+    // the distance field comes from the default font itself so every size keeps its exact metrics
+    Font source = GetFontDefault();
+    Image sourceImage = LoadImageFromTexture(source.texture);
+    if (sourceImage.data == NULL) return false;
+    Color *sourcePixels = LoadImageColors(sourceImage);
+    int count = source.glyphCount;
+    font->baseSize = source.baseSize*UI_FONT_SCALE;
+    font->glyphCount = count;
+    font->glyphs = RL_CALLOC(count, sizeof(GlyphInfo));
+    font->recs = RL_MALLOC(count*sizeof(Rectangle));
+
+    // shelf pack the cells, every glyph grows by the spread on each side
+    int x = 0, y = 0, rowHeight = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int width = (int)source.recs[i].width*UI_FONT_SCALE + 2*UI_FONT_SPREAD;
+        int height = (int)source.recs[i].height*UI_FONT_SCALE + 2*UI_FONT_SPREAD;
+        if (x + width > UI_FONT_ATLAS_WIDTH)
+        {
+            x = 0;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+        font->recs[i] = (Rectangle){ x, y, width, height };
+        int advance = source.glyphs[i].advanceX != 0 ? source.glyphs[i].advanceX : (int)source.recs[i].width;
+        font->glyphs[i] = (GlyphInfo){ source.glyphs[i].value, source.glyphs[i].offsetX*UI_FONT_SCALE - UI_FONT_SPREAD,
+                                       source.glyphs[i].offsetY*UI_FONT_SCALE - UI_FONT_SPREAD, advance*UI_FONT_SCALE };
+        x += width + 1;
+        if (height > rowHeight) rowHeight = height;
+    }
+    int atlasHeight = 1;
+    while (atlasHeight < y + rowHeight) atlasHeight *= 2;
+    *atlas = (Image){ RL_CALLOC((size_t)UI_FONT_ATLAS_WIDTH*atlasHeight, 1), UI_FONT_ATLAS_WIDTH, atlasHeight, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE };
 
+    unsigned char *inside = NULL;
+    for (int i = 0; i < count; i++)
+    {
+        Rectangle from = source.recs[i];
+        Rectangle to = font->recs[i];
+        int width = (int)to.width, height = (int)to.height;
+        inside = RL_REALLOC(inside, (size_t)width*height);
+        for (int py = 0; py < height; py++)
+            for (int px = 0; px < width; px++)
+            {
+                int sx = (int)floorf((float)(px - UI_FONT_SPREAD)/UI_FONT_SCALE);
+                int sy = (int)floorf((float)(py - UI_FONT_SPREAD)/UI_FONT_SCALE);
+                bool set = sx >= 0 && sy >= 0 && sx < (int)from.width && sy < (int)from.height &&
+                           sourcePixels[((int)from.y + sy)*sourceImage.width + (int)from.x + sx].a > 127;
+                inside[py*width + px] = set;
+            }
+        // brute force nearest opposite pixel, it only runs when the cache is missing
+        for (int py = 0; py < height; py++)
+            for (int px = 0; px < width; px++)
+            {
+                bool set = inside[py*width + px];
+                int best = (UI_FONT_SPREAD + 1)*(UI_FONT_SPREAD + 1);
+                for (int dy = -UI_FONT_SPREAD; dy <= UI_FONT_SPREAD; dy++)
+                    for (int dx = -UI_FONT_SPREAD; dx <= UI_FONT_SPREAD; dx++)
+                    {
+                        int nx = px + dx, ny = py + dy;
+                        bool other = nx >= 0 && ny >= 0 && nx < width && ny < height && inside[ny*width + nx];
+                        if (other != set && dx*dx + dy*dy < best) best = dx*dx + dy*dy;
+                    }
+                float distance = sqrtf((float)best) - 0.5f;
+                float value = 0.5f + (set ? distance : -distance)/(2.0f*UI_FONT_SPREAD);
+                ((unsigned char *)atlas->data)[((int)to.y + py)*atlas->width + (int)to.x + px] = (unsigned char)(Clamp(value, 0.0f, 1.0f)*255.0f + 0.5f);
+            }
+    }
+    RL_FREE(inside);
+    UnloadImageColors(sourcePixels);
+    UnloadImage(sourceImage);
+    return true;
 }
-#pragma region  Raction game Start Menu
-void UpdateReactionStartMenu()
+void LoadUiText()
 {
-    reactionStart.pos.x = screenWidth * .35;
-    reactionStart.pos.y = screenHeight * .2;
-    reactionStart.fontScale = screenHeight * .05 ;
-    reactionStart.spaccing = screenHeight * 0.1;
-    reactionStart.sliderSize = (Vector2){screenWidth * .4,screenHeight *.05};
-    reactionStart.ballSizeButton = (Rectangle){0,0,screenWidth * .1,screenHeight*.1};
-    if (IsKeyPressed(KEY_SPACE))
+    double start = ClockSeconds();
+    Font font = { 0 };
+    Image atlas = { 0 };
+    bool cached = LoadUiFontCache(&font, &atlas);
+    if (!cached)
     {
-        reactionGame.gameState = PLAY;
-        //TODO: move this to reaction game start of play
-        DisableCursor();
-        ResetReactionGame();
-        reactionGame.ballColor = ballColors[reactionStart.ballColorIndex];
-        reactionGame.ballSize *= 4;
+        if (!GenerateUiFont(&font, &atlas))
+        {
+            TraceLog(LOG_WARNING, "UITEXT: Failed to read the default font, text stays on DrawText");
+            return;
+        }
+        SaveUiFontCache(&font, atlas);
     }
+    font.texture = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+    SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+    uiText.font = font;
+    uiText.shader = LoadShaderFromMemory(NULL, uiTextShaderCode);
+    uiText.ready = font.texture.id > 0 && IsShaderValid(uiText.shader);
+    TraceLog(LOG_INFO, "UITEXT: Text atlas %dx%d %s in %.1f ms", font.texture.width, font.texture.height,
+             cached ? "loaded" : "generated", (ClockSeconds() - start)*1000.0);
 }
-void DrawReactionStartMenu()
+void UnloadUiText()
 {
-    float x = reactionStart.pos.x;
-    float y = reactionStart.pos.y;
-    int fontSize = reactionStart.fontScale;
-    Color textColor = mainMenuData.fontColor;
-    //mouse sensitivity buttons
-    DrawText(TextFormat("Mouse Sensitivity: %f",reactionStart.mouseSensitivity),x,y,fontSize,textColor);
-    y+=reactionStart.sliderSize.y;
-    GuiSliderBar((Rectangle){ x, y, reactionStart.sliderSize.x, reactionStart.sliderSize.y }, "","", &reactionStart.mouseSensitivity, 0.0f, 10.0f);
-    // balls size buttons
-    y+=reactionStart.spaccing;
-    DrawText(TextFormat("Ball Size: %d",(int)reactionGame.ballSize),x,y,fontSize,textColor);
-    float ballsizeBtnX = x;
-    float ballSizeBtnY = y + fontSize;
-    reactionStart.ballSizeButton.x = ballsizeBtnX;
-    reactionStart.ballSizeButton.y = ballSizeBtnY;
-    DrawText("-",ballsizeBtnX,ballSizeBtnY,fontSize,textColor);
-    if (GuiLabelButton(reactionStart.ballSizeButton, ""))
-    {
-        reactionGame.ballSize -= 1;
-        if(reactionGame.ballSize <=1)
-            reactionGame.ballSize = 1;
-    }
-    ballsizeBtnX+=reactionStart.ballSizeButton.width;
-    reactionStart.ballSizeButton.x = ballsizeBtnX;
-    DrawText("+",ballsizeBtnX,ballSizeBtnY,fontSize,textColor);
-    if (GuiLabelButton(reactionStart.ballSizeButton, ""))
-    {
-        reactionGame.ballSize += 1;
-        if(reactionGame.ballSize >=10)
-            reactionGame.ballSize = 10;
+    if (uiText.font.texture.id > 0) UnloadFont(uiText.font);
+    if (uiText.shader.id > 0) UnloadShader(uiText.shader);
+    RL_FREE(uiText.quads);
+    uiText = (UiText){ 0 };
+}
+void DrawUiText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (!uiText.ready)
+    {
+        DrawText(text, posX, posY, fontSize, color);
+        return;
     }
-    //ball color buttons
-    y+=reactionStart.spaccing +10;
-    DrawText("Ball Color: ", x,y,fontSize,textColor);
-    float rectX = x + MeasureText("Ball Color: ",fontSize);
-    DrawRectangle(rectX,y,fontSize,fontSize,ballColors[reactionStart.ballColorIndex]);
-    ballsizeBtnX = x;
-    ballSizeBtnY = y + fontSize;
-    reactionStart.ballSizeButton.x = ballsizeBtnX;
-    reactionStart.ballSizeButton.y = ballSizeBtnY;
-    DrawText("-",ballsizeBtnX,ballSizeBtnY,fontSize,textColor);
-    if (GuiLabelButton(reactionStart.ballSizeButton, ""))
+    // same sizes and spacing as DrawText so layouts measured with MeasureText still line up
+    if (fontSize < 10) fontSize = 10;
+    float spacing = (float)(fontSize/10);
+    float scale = (float)fontSize/uiText.font.baseSize;
+    float x = posX, y = posY;
+    for (int i = 0; text[i] != '\0';)
     {
-        reactionStart.ballColorIndex -= 1;
-        if(reactionStart.ballColorIndex <=0)
-            reactionStart.ballColorIndex = numBallColors-1;
+        int size = 0;
+        int codepoint = GetCodepointNext(&text[i], &size);
+        i += size;
+        if (codepoint == '\n')
+        {
+            x = posX;
+            y += fontSize + 2;
+            continue;
+        }
+        int index = GetGlyphIndex(uiText.font, codepoint);
+        GlyphInfo *glyph = &uiText.font.glyphs[index];
+        Rectangle source = uiText.font.recs[index];
+        if (codepoint != ' ' && codepoint != '\t')
+        {
+            if (uiText.quadCount == uiText.quadCapacity)
+            {
+                uiText.quadCapacity = uiText.quadCapacity > 0 ? uiText.quadCapacity*2 : 256;
+                uiText.quads = RL_REALLOC(uiText.quads, uiText.quadCapacity*sizeof(UiTextQuad));
+            }
+            uiText.quads[uiText.quadCount++] = (UiTextQuad){
+                { x + glyph->offsetX*scale, y + glyph->offsetY*scale, source.width*scale, source.height*scale }, source, color };
+        }
+        x += glyph->advanceX*scale + spacing;
     }
-    ballsizeBtnX+=reactionStart.ballSizeButton.width;
-    reactionStart.ballSizeButton.x = ballsizeBtnX;
-    DrawText("+",ballsizeBtnX,ballSizeBtnY,fontSize,textColor);
-    if (GuiLabelButton(reactionStart.ballSizeButton, ""))
+}
+void FlushUiText()
+{
+    if (uiText.quadCount == 0) return;
+    // one texture and one shader for all of it, the whole frame's text goes out in a single draw
+    float width = uiText.font.texture.width, height = uiText.font.texture.height;
+    BeginShaderMode(uiText.shader);
+    rlSetTexture(uiText.font.texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < uiText.quadCount; i++)
     {
-        reactionStart.ballColorIndex += 1;
-        if(reactionStart.ballColorIndex >=numBallColors)
-            reactionStart.ballColorIndex = 0;
+        UiTextQuad *q = &uiText.quads[i];
+        rlColor4ub(q->color.r, q->color.g, q->color.b, q->color.a);
+        rlTexCoord2f(q->source.x/width, q->source.y/height);
+        rlVertex2f(q->dest.x, q->dest.y);
+        rlTexCoord2f(q->source.x/width, (q->source.y + q->source.height)/height);
+        rlVertex2f(q->dest.x, q->dest.y + q->dest.height);
+        rlTexCoord2f((q->source.x + q->source.width)/width, (q->source.y + q->source.height)/height);
+        rlVertex2f(q->dest.x + q->dest.width, q->dest.y + q->dest.height);
+        rlTexCoord2f((q->source.x + q->source.width)/width, q->source.y/height);
+        rlVertex2f(q->dest.x + q->dest.width, q->dest.y);
     }
-    
-    // space to start text
-    y=screenHeight*.9;
-    DrawText("Press SPACE to start",x,y,reactionStart.fontScale,mainMenuData.fontColor);
-    
+    rlEnd();
+    rlSetTexture(0);
+    EndShaderMode();
+    uiText.quadCount = 0;
 }
 #pragma endregion
-#pragma region Reaction Game Main Update
-void PickRandomStartBalls()
+#pragma region Profile
+MappedFile MapFile(const char *path)
 {
-    for (int i = 0; i < NUM_BALLS_ON_SCREEN; i++) {
-        reactionGame.activeBallIndexs[i] = GetRandomBall();
-    }   
+    MappedFile file = { 0 };
+#if defined(PLATFORM_WEB)
+    int size = 0;
+    file.data = LoadFileData(path, &size);
+    file.size = size > 0 ? size : 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return file;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *ptr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            file.data = ptr;
+            file.size = st.st_size;
+        }
+    }
+    close(fd);
+#endif
+    return file;
 }
-int GetRandomBall()
+void UnmapFile(MappedFile *file)
 {
-    int newNum;
-    do {
-        newNum = GetRandomValue(0, NUM_REACTION_BALLS-1);
-    } while (IsInActiveArray(newNum)); // Ensure uniqueness
-    return newNum;
+    if (file->data == NULL) return;
+#if defined(PLATFORM_WEB)
+    UnloadFileData(file->data);
+#else
+    munmap(file->data, file->size);
+#endif
+    *file = (MappedFile){ 0 };
 }
-bool IsInActiveArray(int value){
-    for(int i=0;i<NUM_BALLS_ON_SCREEN;i++){
-        if(reactionGame.activeBallIndexs[i] == value)
-            return true;
+void MapProfile()
+{
+    UnmapProfile();
+    profile.file = MapFile(profile.path);
+    if (profile.file.data == NULL) return;
+
+    // reject anything that is not exactly what this build wrote
+    const ProfileHeader *header = (const ProfileHeader *)profile.file.data;
+    if (profile.file.size < sizeof(ProfileHeader) || header->magic != PROFILE_MAGIC ||
+        header->version != PROFILE_VERSION || header->headerSize != sizeof(ProfileHeader))
+    {
+        TraceLog(LOG_WARNING, "PROFILE: [%s] Ignoring invalid profile", profile.path);
+        return;
     }
-    return false;
+    if (header->libraryCount < 0 || header->libraryCount > BG_LIBRARY_SLOTS ||
+        (header->libraryCount > 0 && (header->libraryCurrent < 0 || header->libraryCurrent >= header->libraryCount)))
+    {
+        TraceLog(LOG_WARNING, "PROFILE: [%s] Ignoring corrupt background list", profile.path);
+        return;
+    }
+    profile.header = header;
 }
-void UpdateReactionGame()
+void UnmapProfile()
+{
+    UnmapFile(&profile.file);
+    profile.header = NULL;
+}
+void LoadProfile()
+{
+    snprintf(profile.path, sizeof(profile.path), "%s%s", GetApplicationDirectory(), PROFILE_FILE_NAME);
+    MapProfile();
+    if (profile.header == NULL) return;
+
+    reactionStart.mouseSensitivity = Clamp(profile.header->mouseSensitivity, 0.0f, 10.0f);
+    reactionStart.ballSize = Clamp(profile.header->ballSize, 1.0f, 10.0f);
+    if (profile.header->ballColorIndex >= 0 && profile.header->ballColorIndex < numBallColors)
+        reactionStart.ballColorIndex = profile.header->ballColorIndex;
+    bgCompress.enabled = profile.header->compressBackground != 0;
+    reactionGame.rules.adaptive = profile.header->adaptive != 0;
+    if (profile.header->motion >= 0 && profile.header->motion < MOTION_PATTERN_COUNT) reactionGame.rules.motion = profile.header->motion;
+    reactionGame.rules.humanoid = profile.header->humanoid != 0;
+    // the pixels live in the library directory, the profile only names them
+    library.count = profile.header->libraryCount;
+    library.current = library.count > 0 ? profile.header->libraryCurrent : -1;
+    for (int i = 0; i < library.count; i++) library.entries[i].hash = profile.header->libraryHashes[i];
+}
+void SaveProfile()
 {
-    reactionGame.timer -= dt;
-    if(reactionGame.timer<=0)
+    if (profile.path[0] == '\0') return;
+
+    ProfileHeader header = { 0 };
+    header.magic = PROFILE_MAGIC;
+    header.version = PROFILE_VERSION;
+    header.headerSize = sizeof(ProfileHeader);
+    header.mouseSensitivity = reactionStart.mouseSensitivity;
+    header.ballSize = reactionStart.ballSize;
+    header.ballColorIndex = reactionStart.ballColorIndex;
+    header.compressBackground = bgCompress.enabled;
+    header.adaptive = reactionGame.rules.adaptive;
+    header.motion = reactionGame.rules.motion;
+    header.humanoid = reactionGame.rules.humanoid;
+    // memory only backgrounds have no file to come back to
+    header.libraryCurrent = -1;
+    for (int i = 0; i < library.count; i++)
     {
-        reactionGame.gameState=END;
-        EnableCursor();
+        if (library.entries[i].memoryOnly) continue;
+        if (i == library.current) header.libraryCurrent = header.libraryCount;
+        header.libraryHashes[header.libraryCount++] = library.entries[i].hash;
     }
-    //CAMERA UPDATE
-    // Get mouse movement
-    Vector2 mouseDelta = GetMouseDelta();
-    camSettings.yaw -= mouseDelta.x * reactionStart.mouseSensitivity * camSettings.sensitivity;; // Rotate left/right
-    camSettings.pitch -= mouseDelta.y * reactionStart.mouseSensitivity * camSettings.sensitivity;; // Rotate up/down
-    //camSettings.yaw -= mouseDelta.x * camSettings.sensitivity; // Rotate left/right
-    //camSettings.pitch -= mouseDelta.y * camSettings.sensitivity; // Rotate up/down
+    if (header.libraryCurrent < 0 && header.libraryCount > 0) header.libraryCurrent = 0;
 
-    // Clamp pitch so the camera doesn't look too far up/down
-    camSettings.pitch = Clamp(camSettings.pitch, -camSettings.pitchLimit, camSettings.pitchLimit);
+    // write next to the old profile and swap it in, a crash mid write never leaves a broken profile
+    char tmpPath[sizeof(profile.path) + 8];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", profile.path);
+    FILE *file = fopen(tmpPath, "wb");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "PROFILE: [%s] Failed to open for writing", tmpPath);
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmpPath, profile.path) != 0)
+    {
+        TraceLog(LOG_WARNING, "PROFILE: [%s] Failed to save profile", profile.path);
+        remove(tmpPath);
+        return;
+    }
+    MapProfile();
+}
+#pragma endregion
+#pragma region Image Decode
+int GetWorkerCount()
+{
+#if defined(PLATFORM_WEB)
+    return 1;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1) cores = 1;
+    return cores > DECODE_MAX_THREADS ? DECODE_MAX_THREADS : (int)cores;
+#endif
+}
+// inflate: 64 bit bit buffer and a one probe table for every code up to INFLATE_FAST_BITS long
+static const unsigned short inflateLengthBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+static const unsigned char inflateLengthExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+static const unsigned short inflateDistBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+static const unsigned char inflateDistExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+static const unsigned char inflateCodeLengthOrder[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
 
-    camSettings.yaw = Clamp(camSettings.yaw,-camSettings.yawLimit,camSettings.yawLimit);
+static int ReverseBits(int code, int length)
+{
+    int result = 0;
+    for (int i = 0; i < length; i++, code >>= 1) result = (result << 1) | (code & 1);
+    return result;
+}
+static bool BuildInflateHuffman(InflateHuffman *huffman, const unsigned char *lengths, int count)
+{
+    int lengthCount[17] = { 0 };
+    int nextCode[16];
+    memset(huffman->fast, 0, sizeof(huffman->fast));
+    for (int i = 0; i < count; i++) lengthCount[lengths[i]]++;
+    lengthCount[0] = 0;
 
-    // Calculate new camera target
-    Vector3 forward = {
-        cosf(camSettings.pitch) * sinf(camSettings.yaw), // X-axis rotation
-        sinf(camSettings.pitch),             // Y-axis rotation
-        cosf(camSettings.pitch) * cosf(camSettings.yaw)  // Z-axis rotation
-    };
+    int code = 0;
+    int index = 0;
+    for (int i = 1; i < 16; i++)
+    {
+        nextCode[i] = code;
+        huffman->firstCode[i] = code;
+        huffman->firstSymbol[i] = index;
+        code += lengthCount[i];
+        if (lengthCount[i] > 0 && code - 1 >= (1 << i)) return false;
+        huffman->maxCode[i] = code << (16 - i);
+        code <<= 1;
+        index += lengthCount[i];
+    }
+    huffman->maxCode[16] = 0x10000;
+    for (int i = 0; i < count; i++)
+    {
+        int length = lengths[i];
+        if (length == 0) continue;
+        int slot = nextCode[length] - huffman->firstCode[length] + huffman->firstSymbol[length];
+        huffman->length[slot] = length;
+        huffman->symbol[slot] = i;
+        if (length <= INFLATE_FAST_BITS)
+        {
+            for (int j = ReverseBits(nextCode[length], length); j < (1 << INFLATE_FAST_BITS); j += 1 << length)
+                huffman->fast[j] = (length << 9) | i;
+        }
+        nextCode[length]++;
+    }
+    return true;
+}
+static inline void InflateRefill(Inflater *z)
+{
+    if (z->inEnd - z->in >= 8)
+    {
+        // branchless refill, only whole bytes are consumed from the input
+        unsigned long long word;
+        memcpy(&word, z->in, 8);
+        z->bits |= word << z->bitCount;
+        z->in += (63 - z->bitCount) >> 3;
+        z->bitCount |= 56;
+        return;
+    }
+    while (z->bitCount <= 56)
+    {
+        if (z->in < z->inEnd) z->bits |= (unsigned long long)*z->in++ << z->bitCount;
+        else z->overread++;
+        z->bitCount += 8;
+    }
+}
+static inline unsigned int InflateBits(Inflater *z, int count)
+{
+    if (z->bitCount < count) InflateRefill(z);
+    unsigned int value = (unsigned int)(z->bits & ((1ull << count) - 1));
+    z->bits >>= count;
+    z->bitCount -= count;
+    return value;
+}
+static inline int InflateDecode(Inflater *z, const InflateHuffman *huffman)
+{
+    if (z->bitCount < 16) InflateRefill(z);
+    int entry = huffman->fast[z->bits & ((1 << INFLATE_FAST_BITS) - 1)];
+    if (entry)
+    {
+        int length = entry >> 9;
+        z->bits >>= length;
+        z->bitCount -= length;
+        return entry & 511;
+    }
+    // codes longer than the table are rare, walk the canonical code lengths
+    int code = ReverseBits((int)(z->bits & 0xffff), 16);
+    int length = INFLATE_FAST_BITS + 1;
+    while (code >= huffman->maxCode[length]) length++;
+    if (length >= 16) return -1;
+    int slot = (code >> (16 - length)) - huffman->firstCode[length] + huffman->firstSymbol[length];
+    if (slot >= 288 || huffman->length[slot] != length) return -1;
+    z->bits >>= length;
+    z->bitCount -= length;
+    return huffman->symbol[slot];
+}
+static inline void InflatePublish(Inflater *z)
+{
+    if (z->progress != NULL) atomic_store_explicit(z->progress, (size_t)(z->out - z->outStart), memory_order_release);
+}
+static bool InflateCodes(Inflater *z, const InflateHuffman *lit, const InflateHuffman *dist)
+{
+    unsigned char *out = z->out;
+    unsigned char *outStart = z->outStart;
+    unsigned char *outEnd = z->outEnd;
+    unsigned char *nextPublish = out + INFLATE_PUBLISH_BYTES;
+    for (;;)
+    {
+        int symbol = InflateDecode(z, lit);
+        if (symbol < 256)
+        {
+            if (symbol < 0 || out >= outEnd) return false;
+            *out++ = (unsigned char)symbol;
+        }
+        else if (symbol == 256) break;
+        else
+        {
+            symbol -= 257;
+            if (symbol >= 29) return false;
+            int length = inflateLengthBase[symbol] + InflateBits(z, inflateLengthExtra[symbol]);
+            symbol = InflateDecode(z, dist);
+            if (symbol < 0 || symbol >= 30) return false;
+            int distance = inflateDistBase[symbol] + InflateBits(z, inflateDistExtra[symbol]);
+            if (out - outStart < distance || outEnd - out < length) return false;
 
-    // Set the camera target relative to position
-    camera.target = (Vector3){
-        camera.position.x + forward.x,
-        camera.position.y + forward.y,
-        camera.position.z + forward.z
-    };
-    //RAY CAST
-     // Get the center of the screen
-    Vector2 screenCenter = { screenWidth / 2, screenHeight / 2 };
+            const unsigned char *src = out - distance;
+            if (distance >= 8 && outEnd - out >= length + 8)
+            {
+                // 8 byte chunks, the last one may run past the match but never past the buffer
+                unsigned char *dst = out;
+                unsigned char *dstEnd = out + length;
+                do { memcpy(dst, src, 8); dst += 8; src += 8; } while (dst < dstEnd);
+            }
+            else if (distance == 1) memset(out, *src, length);
+            else for (int i = 0; i < length; i++) out[i] = src[i];
+            out += length;
+        }
 
-    // Generate a ray from the center of the screen
-    //Calculate ball positions
-    reactionGame.ballOffset = 70;//reactionGame.ballSize * 5;
-    float increment = (reactionGame.ballSize/2) + reactionGame.ballOffset;
-    float startX = (reactionGame.ballSize/2) + reactionGame.ballOffset *2 + reactionGame.ballSize*2;
-    startX = startX;
-    float startY = (reactionGame.ballSize/2) + reactionGame.ballOffset * 2 + reactionGame.ballSize * 2;
-    startY = -startY;
-    int counter = 0;
-    int row = 0;
-    
-    float y = startY;
-    for(int i =0; i <NUM_BALL_COLS;++i){
-        float x = startX;
-        for(int j =0;j<NUM_BALL_ROWS;++j){
-            reactionGame.ballPositions[counter].x = x;
-            reactionGame.ballPositions[counter].y = y;
-            reactionGame.ballPositions[counter].z = 700;
-            ++counter;
-            x -= increment;
+        if (out >= nextPublish)
+        {
+            z->out = out;
+            InflatePublish(z);
+            nextPublish = out + INFLATE_PUBLISH_BYTES;
         }
-        y+=increment;            
     }
-    Ray ray = GetMouseRay(screenCenter, camera);
-    RayCollision col;
-    if(IsMouseButtonPressed(MOUSE_BUTTON_LEFT)){
-        reactionGame.numClicks++;
-        for(int i =0; i <NUM_BALLS_ON_SCREEN;++i){
-            col = GetRayCollisionSphere(ray, reactionGame.ballPositions[reactionGame.activeBallIndexs[i]],reactionGame.ballSize+5);
-            if(col.hit)
+    z->out = out;
+    InflatePublish(z);
+    return z->overread <= 8;
+}
+static bool InflateDynamicTables(Inflater *z, InflateHuffman *lit, InflateHuffman *dist)
+{
+    unsigned char codeLengthLengths[19] = { 0 };
+    unsigned char lengths[288 + 32];
+    int litCount = InflateBits(z, 5) + 257;
+    int distCount = InflateBits(z, 5) + 1;
+    int codeLengthCount = InflateBits(z, 4) + 4;
+    for (int i = 0; i < codeLengthCount; i++) codeLengthLengths[inflateCodeLengthOrder[i]] = InflateBits(z, 3);
+
+    InflateHuffman codeLengths;
+    if (!BuildInflateHuffman(&codeLengths, codeLengthLengths, 19)) return false;
+    int count = 0;
+    while (count < litCount + distCount)
+    {
+        int symbol = InflateDecode(z, &codeLengths);
+        if (symbol < 0 || symbol >= 19) return false;
+        if (symbol < 16) { lengths[count++] = symbol; continue; }
+
+        int repeat;
+        unsigned char fill = 0;
+        if (symbol == 16)
+        {
+            if (count == 0) return false;
+            repeat = InflateBits(z, 2) + 3;
+            fill = lengths[count - 1];
+        }
+        else if (symbol == 17) repeat = InflateBits(z, 3) + 3;
+        else repeat = InflateBits(z, 7) + 11;
+        if (count + repeat > litCount + distCount) return false;
+        memset(lengths + count, fill, repeat);
+        count += repeat;
+    }
+    return BuildInflateHuffman(lit, lengths, litCount) && BuildInflateHuffman(dist, lengths + litCount, distCount);
+}
+static bool InflateStored(Inflater *z)
+{
+    // hand back the whole bytes still sitting in the bit buffer and copy straight from the input
+    InflateBits(z, z->bitCount & 7);
+    int buffered = (z->bitCount >> 3) - z->overread;
+    if (buffered < 0) return false;
+    z->in -= buffered;
+    z->overread = 0;
+    z->bits = 0;
+    z->bitCount = 0;
+    if (z->inEnd - z->in < 4) return false;
+    int length = z->in[0] | (z->in[1] << 8);
+    int check = z->in[2] | (z->in[3] << 8);
+    z->in += 4;
+    if ((length ^ 0xffff) != check || z->inEnd - z->in < length || z->outEnd - z->out < length) return false;
+    memcpy(z->out, z->in, length);
+    z->in += length;
+    z->out += length;
+    InflatePublish(z);
+    return true;
+}
+bool InflateZlib(Inflater *z)
+{
+    static InflateHuffman fixedLit, fixedDist;
+    static atomic_int fixedBuilt;
+    if (z->inEnd - z->in < 2) return false;
+    int cmf = z->in[0];
+    int flg = z->in[1];
+    if ((cmf & 15) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 32)) return false;
+    z->in += 2;
+
+    bool final = false;
+    while (!final)
+    {
+        final = InflateBits(z, 1);
+        int type = InflateBits(z, 2);
+        bool ok;
+        if (type == 0) ok = InflateStored(z);
+        else if (type == 1)
+        {
+            if (!atomic_load(&fixedBuilt))
             {
-                //TODO: update scores when ball hit
-                reactionGame.activeBallIndexs[i] = GetRandomBall();
-                reactionGame.score++;
+                // concurrent decoders may both build it, they write identical tables
+                unsigned char lengths[288];
+                memset(lengths, 8, 144);
+                memset(lengths + 144, 9, 112);
+                memset(lengths + 256, 7, 24);
+                memset(lengths + 280, 8, 8);
+                BuildInflateHuffman(&fixedLit, lengths, 288);
+                memset(lengths, 5, 30);
+                BuildInflateHuffman(&fixedDist, lengths, 30);
+                atomic_store(&fixedBuilt, 1);
             }
+            ok = InflateCodes(z, &fixedLit, &fixedDist);
+        }
+        else if (type == 2)
+        {
+            InflateHuffman lit, dist;
+            ok = InflateDynamicTables(z, &lit, &dist) && InflateCodes(z, &lit, &dist);
         }
-        reactionGame.accuracy = (float)reactionGame.score / (float)reactionGame.numClicks;
+        else ok = false;
+        if (!ok) return false;
     }
+    return true;
 }
-void DrawReactionGame()
+
+// png unfiltering, rows are reconstructed out of place so inflate can keep reading its back references
+static inline int PaethPredictor(int a, int b, int c)
 {
-    BeginMode3D(camera);
-    for(int i =0;i<NUM_BALLS_ON_SCREEN;++i){
-        DrawSphere(reactionGame.ballPositions[reactionGame.activeBallIndexs[i]],reactionGame.ballSize, reactionGame.ballColor);
-    }
-    Vector3 pos = {0,0,100};
-    Vector3 size = {200,100,300};
-    DrawCubeWiresV(pos,size,BLACK);
-    EndMode3D();
-    float x = screenWidth * .2;
-    float y = 10;
-    DrawText(TextFormat("Score: %d",reactionGame.score),x,y,20,BLACK);
-    x = x + 110;
-    DrawText(TextFormat("Accuracy: %f",reactionGame.accuracy),x,y,20,BLACK);
-    
-    x = x + 210;
-    DrawText(TextFormat("Time: %d",(int)reactionGame.timer),x,y,20,BLACK);
-    
-    //crosshair
-    DrawText(TextFormat("+"),screenWidth/2,screenHeight/2-10,20,BLACK);
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
 }
-#pragma endregion
-#pragma region Reaction Game End
-void UpdateReactionGameEnd()
+#if defined(__SSE2__)
+static inline __m128i LoadPixel(const unsigned char *p, int bpp)
 {
-    if(IsKeyPressed(KEY_SPACE))
+    int value = 0;
+    memcpy(&value, p, bpp);
+    return _mm_cvtsi32_si128(value);
+}
+static inline void StorePixel(unsigned char *p, __m128i v, int bpp)
+{
+    int value = _mm_cvtsi128_si32(v);
+    memcpy(p, &value, bpp);
+}
+static inline __m128i AbsEpi16(__m128i x)
+{
+    __m128i sign = _mm_srai_epi16(x, 15);
+    return _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
+}
+static inline __m128i SelectEpi16(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+#endif
+void UnfilterPngRow(int filter, unsigned char *cur, const unsigned char *raw, const unsigned char *prev, int rowBytes, int bpp)
+{
+    int i = 0;
+    switch (filter)
     {
-        reactionGame.gameState = START;
+    case 0:
+        memcpy(cur, raw, rowBytes);
+        return;
+    case 1:
+#if defined(__SSE2__)
+        if (bpp == 3 || bpp == 4)
+        {
+            __m128i a = _mm_setzero_si128();
+            for (; i + bpp <= rowBytes; i += bpp)
+            {
+                a = _mm_add_epi8(a, LoadPixel(raw + i, bpp));
+                StorePixel(cur + i, a, bpp);
+            }
+        }
+#endif
+        for (; i < bpp && i < rowBytes; i++) cur[i] = raw[i];
+        for (; i < rowBytes; i++) cur[i] = raw[i] + cur[i - bpp];
+        return;
+    case 2:
+#if defined(__SSE2__)
+        for (; i + 16 <= rowBytes; i += 16)
+        {
+            __m128i r = _mm_loadu_si128((const __m128i *)(raw + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(prev + i));
+            _mm_storeu_si128((__m128i *)(cur + i), _mm_add_epi8(r, b));
+        }
+#endif
+        for (; i < rowBytes; i++) cur[i] = raw[i] + prev[i];
+        return;
+    case 3:
+#if defined(__SSE2__)
+        if (bpp == 3 || bpp == 4)
+        {
+            // pavgb rounds up, png truncates, take the low bit of a^b back off
+            __m128i one = _mm_set1_epi8(1);
+            __m128i a = _mm_setzero_si128();
+            for (; i + bpp <= rowBytes; i += bpp)
+            {
+                __m128i b = LoadPixel(prev + i, bpp);
+                __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+                a = _mm_add_epi8(avg, LoadPixel(raw + i, bpp));
+                StorePixel(cur + i, a, bpp);
+            }
+        }
+#endif
+        for (; i < bpp && i < rowBytes; i++) cur[i] = raw[i] + (prev[i] >> 1);
+        for (; i < rowBytes; i++) cur[i] = raw[i] + ((cur[i - bpp] + prev[i]) >> 1);
+        return;
+    case 4:
+#if defined(__SSE2__)
+        if (bpp == 3 || bpp == 4)
+        {
+            // all three distances in 16 bit lanes, then pick a, b or c per byte without branches
+            __m128i zero = _mm_setzero_si128();
+            __m128i a = zero;
+            __m128i c = zero;
+            for (; i + bpp <= rowBytes; i += bpp)
+            {
+                __m128i b = _mm_unpacklo_epi8(LoadPixel(prev + i, bpp), zero);
+                __m128i pa = _mm_sub_epi16(b, c);
+                __m128i pb = _mm_sub_epi16(a, c);
+                __m128i pc = AbsEpi16(_mm_add_epi16(pa, pb));
+                pa = AbsEpi16(pa);
+                pb = AbsEpi16(pb);
+                __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+                __m128i predictor = SelectEpi16(_mm_cmpeq_epi16(smallest, pa), a, SelectEpi16(_mm_cmpeq_epi16(smallest, pb), b, c));
+                __m128i x = _mm_add_epi8(_mm_packus_epi16(predictor, predictor), LoadPixel(raw + i, bpp));
+                StorePixel(cur + i, x, bpp);
+                a = _mm_unpacklo_epi8(x, zero);
+                c = b;
+            }
+        }
+#endif
+        for (; i < bpp && i < rowBytes; i++) cur[i] = raw[i] + prev[i];
+        for (; i < rowBytes; i++) cur[i] = raw[i] + PaethPredictor(cur[i - bpp], prev[i], prev[i - bpp]);
+        return;
+    default:
+        return;
     }
 }
-void DrawReactionGameEnd()
-{   
-    float x = reactionStart.pos.x;
-    float y = reactionStart.pos.y;
-    int fontSize = reactionStart.fontScale;
-    Color textColor = mainMenuData.fontColor;
-    //score
-    DrawText(TextFormat("Score: %d",reactionGame.score),x,y,fontSize,textColor);
-    //accuracy
-    y+=reactionStart.spaccing;
-    DrawText(TextFormat("Accuracy: %f",reactionGame.accuracy),x,y,fontSize,textColor);
-    //numhits
-    y+=reactionStart.spaccing;
-    //DrawText(TextFormat("Targets Hit: %d",reactionGame.Nu),x,y,fontSize,textColor);
 
-    //press space text
-    y=screenHeight*.9;
-    DrawText("Press SPACE to restart",x,y,reactionStart.fontScale,mainMenuData.fontColor);
+// pixel expansion to RGBA8
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("ssse3"))) static void ExpandRgbRowSsse3(unsigned int *dst, const unsigned char *src, int width)
+{
+    __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m128i alpha = _mm_set1_epi32((int)0xff000000);
+    int x = 0;
+    // 16 byte loads read 4 bytes past the 12 used, stop while that stays inside the row
+    for (; x + 6 <= width; x += 4)
+    {
+        __m128i rgb = _mm_loadu_si128((const __m128i *)(src + x*3));
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+    for (; x < width; x++) dst[x] = src[x*3] | (src[x*3 + 1] << 8) | (src[x*3 + 2] << 16) | 0xff000000u;
+}
+#endif
+static void ExpandPngRow(unsigned char *dst, const unsigned char *src, int width, int colorType, const unsigned int *palette)
+{
+    unsigned int *out = (unsigned int *)dst;
+    switch (colorType)
+    {
+    case 0:
+        for (int x = 0; x < width; x++) out[x] = src[x]*0x010101u | 0xff000000u;
+        break;
+    case 2:
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_cpu_supports("ssse3"))
+        {
+            ExpandRgbRowSsse3(out, src, width);
+            break;
+        }
+#endif
+        for (int x = 0; x < width; x++) out[x] = src[x*3] | (src[x*3 + 1] << 8) | (src[x*3 + 2] << 16) | 0xff000000u;
+        break;
+    case 3:
+        for (int x = 0; x < width; x++) out[x] = palette[src[x]];
+        break;
+    case 4:
+        for (int x = 0; x < width; x++) out[x] = src[x*2]*0x010101u | ((unsigned int)src[x*2 + 1] << 24);
+        break;
+    default:
+        break;
+    }
+}
+static unsigned int ReadBigEndian32(const unsigned char *p)
+{
+    return ((unsigned int)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+static void UnfilterPngRows(PngDecode *png)
+{
+    const unsigned char *prev = png->scratch + png->rowBytes*2;   // zero row above the image
+    for (int y = 0; y < png->height; y++)
+    {
+        size_t needed = (y + 1)*(png->rowBytes + 1);
+        while (atomic_load_explicit(&png->progress, memory_order_acquire) < needed)
+        {
+            if (atomic_load(&png->z.done) && atomic_load_explicit(&png->progress, memory_order_acquire) < needed) return;
+#if !defined(PLATFORM_WEB)
+            sched_yield();
+#endif
+        }
+        const unsigned char *row = png->raw + y*(png->rowBytes + 1);
+        if (row[0] > 4) return;
+        // RGBA rows reconstruct straight into the image, the rest go through two scratch rows
+        unsigned char *dst = png->pixels + (size_t)y*png->width*4;
+        unsigned char *cur = png->colorType == 6 ? dst : png->scratch + (y & 1)*png->rowBytes;
+        UnfilterPngRow(row[0], cur, row + 1, prev, (int)png->rowBytes, png->channels);
+        if (png->colorType != 6) ExpandPngRow(dst, cur, png->width, png->colorType, png->palette);
+        prev = cur;
+    }
+    png->ok = true;
+}
+static void DecodePngStage(void *ctx, int stage)
+{
+    // inflate is always handed out first, so the rows only ever wait on a stage that is running
+    PngDecode *png = ctx;
+    if (stage == 0)
+    {
+        png->z.ok = InflateZlib(&png->z);
+        atomic_store(&png->z.done, 1);
+    }
+    else UnfilterPngRows(png);
+}
+bool DecodePngFast(const unsigned char *data, int size, Image *image)
+{
+    static const unsigned char signature[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+    if (size < 8 || memcmp(data, signature, 8) != 0) return false;
+
+    int width = 0, height = 0, depth = 0, colorType = -1, interlace = 0;
+    bool hasKey = false;
+    unsigned int palette[256];
+    for (int i = 0; i < 256; i++) palette[i] = 0xff000000u;
+    const unsigned char *idat = NULL;
+    size_t idatSize = 0;
+    unsigned char *joined = NULL;
+
+    // walk the chunks, a single IDAT is used in place, split ones get joined
+    const unsigned char *p = data + 8;
+    const unsigned char *end = data + size;
+    while (end - p >= 12)
+    {
+        unsigned int length = ReadBigEndian32(p);
+        const unsigned char *type = p + 4;
+        const unsigned char *chunk = p + 8;
+        if (length > (size_t)(end - chunk) - 4) break;
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13)
+        {
+            width = ReadBigEndian32(chunk);
+            height = ReadBigEndian32(chunk + 4);
+            depth = chunk[8];
+            colorType = chunk[9];
+            interlace = chunk[12];
+        }
+        else if (memcmp(type, "PLTE", 4) == 0)
+        {
+            for (unsigned int i = 0; i < length/3 && i < 256; i++)
+                palette[i] = chunk[i*3] | (chunk[i*3 + 1] << 8) | (chunk[i*3 + 2] << 16) | 0xff000000u;
+        }
+        else if (memcmp(type, "tRNS", 4) == 0)
+        {
+            if (colorType == 3) for (unsigned int i = 0; i < length && i < 256; i++) palette[i] = (palette[i] & 0xffffff) | ((unsigned int)chunk[i] << 24);
+            else hasKey = true;
+        }
+        else if (memcmp(type, "IDAT", 4) == 0)
+        {
+            if (idat == NULL) { idat = chunk; idatSize = length; }
+            else
+            {
+                unsigned char *grown = realloc(joined, idatSize + length);
+                if (grown == NULL) { free(joined); return false; }
+                if (joined == NULL) memcpy(grown, idat, idatSize);
+                joined = grown;
+                memcpy(joined + idatSize, chunk, length);
+                idat = joined;
+                idatSize += length;
+            }
+        }
+        else if (memcmp(type, "IEND", 4) == 0) break;
+        p = chunk + length + 4;
+    }
+
+    // anything unusual for a screenshot is left to stb_image
+    int channels = colorType == 0 ? 1 : colorType == 2 ? 3 : colorType == 3 ? 1 : colorType == 4 ? 2 : colorType == 6 ? 4 : 0;
+    if (idat == NULL || channels == 0 || depth != 8 || interlace != 0 || hasKey ||
+        width <= 0 || height <= 0 || width > 32768 || height > 32768)
+    {
+        free(joined);
+        return false;
+    }
+
+    size_t rowBytes = (size_t)width*channels;
+    size_t rawSize = (rowBytes + 1)*height;
+    unsigned char *raw = malloc(rawSize);
+    unsigned char *pixels = malloc((size_t)width*height*4);
+    unsigned char *scratch = malloc(rowBytes*3);
+    if (raw == NULL || pixels == NULL || scratch == NULL)
+    {
+        free(raw); free(pixels); free(scratch); free(joined);
+        return false;
+    }
+    memset(scratch + rowBytes*2, 0, rowBytes);
+
+    PngDecode png = { .raw = raw, .pixels = pixels, .scratch = scratch, .palette = palette, .rowBytes = rowBytes,
+                      .width = width, .height = height, .channels = channels, .colorType = colorType };
+    atomic_init(&png.progress, 0);
+    png.z.in = idat;
+    png.z.inEnd = idat + idatSize;
+    png.z.out = png.z.outStart = raw;
+    png.z.outEnd = raw + rawSize;
+    png.z.progress = &png.progress;
+    atomic_init(&png.z.done, 0);
+
+    // inflate runs ahead on one thread while another unfilters each row as soon as it is complete, alone they just run in turn
+    ParallelFor(2, DecodePngStage, &png);
+    bool ok = png.ok && png.z.ok;
+    free(raw);
+    free(scratch);
+    free(joined);
+    if (!ok)
+    {
+        free(pixels);
+        return false;
+    }
+    *image = (Image){ .data = pixels, .width = width, .height = height, .mipmaps = 1, .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    return true;
+}
+
+// baseline jpeg, restart intervals are entropy decoded in parallel and rows color converted in parallel
+static const unsigned char jpegZigzag[64 + 16] = {
+    0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    // run lengths past the end land on a harmless slot instead of out of bounds
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+static bool BuildJpegHuffman(JpegHuffman *huffman, const unsigned char *counts, const unsigned char *symbols, int symbolCount)
+{
+    memset(huffman->fast, 0, sizeof(huffman->fast));
+    memcpy(huffman->symbols, symbols, symbolCount);
+    int code = 0;
+    int index = 0;
+    for (int length = 1; length <= 16; length++)
+    {
+        huffman->offset[length] = index - code;
+        for (int i = 0; i < counts[length - 1]; i++, index++, code++)
+        {
+            if (code >= (1 << length)) return false;
+            if (length <= JPEG_FAST_BITS)
+            {
+                int shift = JPEG_FAST_BITS - length;
+                for (int j = 0; j < (1 << shift); j++) huffman->fast[(code << shift) | j] = (length << 8) | symbols[index];
+            }
+        }
+        huffman->maxCode[length] = code;
+        code <<= 1;
+    }
+    return true;
+}
+static inline void JpegRefill(JpegBits *bits)
+{
+    while (bits->count <= 56)
+    {
+        unsigned int byte = 0;
+        if (bits->in < bits->end)
+        {
+            byte = *bits->in++;
+            // stuffed zero after 0xff, the segments were cut before any other marker
+            if (byte == 0xff && bits->in < bits->end && *bits->in == 0x00) bits->in++;
+        }
+        bits->buffer |= (unsigned long long)byte << (56 - bits->count);
+        bits->count += 8;
+    }
+}
+static inline int JpegDecodeSymbol(JpegBits *bits, const JpegHuffman *huffman)
+{
+    if (bits->count < 16) JpegRefill(bits);
+    int entry = huffman->fast[bits->buffer >> (64 - JPEG_FAST_BITS)];
+    if (entry)
+    {
+        bits->buffer <<= entry >> 8;
+        bits->count -= entry >> 8;
+        return entry & 255;
+    }
+    for (int length = JPEG_FAST_BITS + 1; length <= 16; length++)
+    {
+        int code = (int)(bits->buffer >> (64 - length));
+        if (code < huffman->maxCode[length])
+        {
+            bits->buffer <<= length;
+            bits->count -= length;
+            return huffman->symbols[(code + huffman->offset[length]) & 255];
+        }
+    }
+    bits->error = true;
+    return 0;
+}
+static inline int JpegReceiveExtend(JpegBits *bits, int size)
+{
+    if (size == 0) return 0;
+    if (bits->count < size) JpegRefill(bits);
+    int value = (int)(bits->buffer >> (64 - size));
+    bits->buffer <<= size;
+    bits->count -= size;
+    return value < (1 << (size - 1)) ? value - (1 << size) + 1 : value;
+}
+#define JPEG_FIX(x) ((int)((x)*4096 + 0.5f))
+#define JPEG_IDCT_1D(type, s0, s1, s2, s3, s4, s5, s6, s7) \
+    type t0, t1, t2, t3, p1, p2, p3, p4, p5, x0, x1, x2, x3; \
+    p1 = ((s2) + (s6))*JPEG_FIX(0.5411961f); \
+    t2 = p1 + (s6)*JPEG_FIX(-1.847759065f); \
+    t3 = p1 + (s2)*JPEG_FIX(0.765366865f); \
+    t0 = ((s0) + (s4))*4096; \
+    t1 = ((s0) - (s4))*4096; \
+    x0 = t0 + t3; x3 = t0 - t3; x1 = t1 + t2; x2 = t1 - t2; \
+    t0 = (s7); t1 = (s5); t2 = (s3); t3 = (s1); \
+    p3 = t0 + t2; p4 = t1 + t3; p1 = t0 + t3; p2 = t1 + t2; \
+    p5 = (p3 + p4)*JPEG_FIX(1.175875602f); \
+    t0 *= JPEG_FIX(0.298631336f); t1 *= JPEG_FIX(2.053119869f); \
+    t2 *= JPEG_FIX(3.072711026f); t3 *= JPEG_FIX(1.501321110f); \
+    p1 = p5 + p1*JPEG_FIX(-0.899976223f); p2 = p5 + p2*JPEG_FIX(-2.562915447f); \
+    p3 *= JPEG_FIX(-1.961570560f); p4 *= JPEG_FIX(-0.390180644f); \
+    t3 += p1 + p4; t2 += p2 + p3; t1 += p2 + p4; t0 += p1 + p3;
+static inline unsigned char JpegClamp(int x)
+{
+    return x < 0 ? 0 : x > 255 ? 255 : (unsigned char)x;
+}
+static void JpegIdctBlock(unsigned char *out, int stride, const short *coeffs)
+{
+    int temp[64];
+    // columns first, with two extra bits of precision kept between the passes
+    for (int i = 0; i < 8; i++)
+    {
+        const short *d = coeffs + i;
+        int *v = temp + i;
+        if (!(d[8] | d[16] | d[24] | d[32] | d[40] | d[48] | d[56]))
+        {
+            int dc = d[0]*4;
+            v[0] = v[8] = v[16] = v[24] = v[32] = v[40] = v[48] = v[56] = dc;
+            continue;
+        }
+        JPEG_IDCT_1D(int, d[0], d[8], d[16], d[24], d[32], d[40], d[48], d[56])
+        x0 += 512; x1 += 512; x2 += 512; x3 += 512;
+        v[0] = (x0 + t3) >> 10; v[56] = (x0 - t3) >> 10;
+        v[8] = (x1 + t2) >> 10; v[48] = (x1 - t2) >> 10;
+        v[16] = (x2 + t1) >> 10; v[40] = (x2 - t1) >> 10;
+        v[24] = (x3 + t0) >> 10; v[32] = (x3 - t0) >> 10;
+    }
+    for (int i = 0; i < 8; i++, out += stride)
+    {
+        // 64 bit so corrupt coefficients can't overflow, real blocks never come close
+        const int *v = temp + i*8;
+        JPEG_IDCT_1D(long long, v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7])
+        // 1<<17 of scale to remove, rounding and the +128 level shift folded in
+        x0 += 65536 + (128 << 17); x1 += 65536 + (128 << 17);
+        x2 += 65536 + (128 << 17); x3 += 65536 + (128 << 17);
+        out[0] = JpegClamp((x0 + t3) >> 17); out[7] = JpegClamp((x0 - t3) >> 17);
+        out[1] = JpegClamp((x1 + t2) >> 17); out[6] = JpegClamp((x1 - t2) >> 17);
+        out[2] = JpegClamp((x2 + t1) >> 17); out[5] = JpegClamp((x2 - t1) >> 17);
+        out[3] = JpegClamp((x3 + t0) >> 17); out[4] = JpegClamp((x3 - t0) >> 17);
+    }
+}
+static inline short JpegDequantize(int value, int quant)
+{
+    // clamped to what 8 bit samples can produce, keeps the first idct pass inside 32 bits
+    long long x = (long long)value*quant;
+    return (short)(x < -16384 ? -16384 : x > 16383 ? 16383 : x);
+}
+static void JpegDecodeBlock(JpegDecoder *jpeg, JpegBits *bits, int c, int *dcPred, unsigned char *out, int stride)
+{
+    JpegComponent *comp = &jpeg->components[c];
+    const JpegHuffman *dc = &jpeg->huffman[comp->dcTable];
+    const JpegHuffman *ac = &jpeg->huffman[4 + comp->acTable];
+    const unsigned short *quant = jpeg->quant[comp->quantTable];
+    short coeffs[64] = { 0 };
+
+    int size = JpegDecodeSymbol(bits, dc);
+    if (size > 11) { bits->error = true; return; }
+    *dcPred += JpegReceiveExtend(bits, size);
+    if (*dcPred < -32768 || *dcPred > 32767) { bits->error = true; return; }
+    coeffs[0] = JpegDequantize(*dcPred, quant[0]);
+    for (int k = 1; k < 64;)
+    {
+        int rs = JpegDecodeSymbol(bits, ac);
+        int run = rs >> 4;
+        size = rs & 15;
+        if (size == 0)
+        {
+            if (run != 15) break;
+            k += 16;
+            continue;
+        }
+        k += run;
+        if (k > 63 || size > 10) { bits->error = true; return; }
+        coeffs[jpegZigzag[k]] = JpegDequantize(JpegReceiveExtend(bits, size), quant[k]);
+        k++;
+    }
+    JpegIdctBlock(out, stride, coeffs);
+}
+static void JpegDecodeInterval(void *ctx, int task)
+{
+    JpegDecoder *jpeg = ctx;
+    int first = task*jpeg->intervalsPerTask;
+    int last = first + jpeg->intervalsPerTask;
+    if (last > jpeg->segmentCount) last = jpeg->segmentCount;
+    for (int segment = first; segment < last; segment++)
+    {
+        JpegBits bits = { .in = jpeg->segments[segment].start, .end = jpeg->segments[segment].end };
+        int dcPred[3] = { 0 };
+        int mcu = segment*jpeg->restartInterval;
+        int mcuEnd = jpeg->restartInterval > 0 ? mcu + jpeg->restartInterval : jpeg->mcuCount;
+        if (mcuEnd > jpeg->mcuCount) mcuEnd = jpeg->mcuCount;
+        for (; mcu < mcuEnd && !bits.error; mcu++)
+        {
+            int mcuX = mcu % jpeg->mcusX;
+            int mcuY = mcu / jpeg->mcusX;
+            for (int c = 0; c < jpeg->componentCount; c++)
+            {
+                JpegComponent *comp = &jpeg->components[c];
+                for (int by = 0; by < comp->v; by++)
+                for (int bx = 0; bx < comp->h; bx++)
+                {
+                    int x = (mcuX*comp->h + bx)*8;
+                    int y = (mcuY*comp->v + by)*8;
+                    JpegDecodeBlock(jpeg, &bits, c, &dcPred[c], comp->plane + (size_t)y*comp->stride + x, comp->stride);
+                }
+            }
+        }
+        if (bits.error) atomic_store(&jpeg->failed, 1);
+    }
+}
+static void JpegUpsampleRow(const JpegDecoder *jpeg, const JpegComponent *comp, int y, unsigned char *out)
+{
+    // centered bilinear, matches libjpeg's fancy upsampling for 2x factors
+    if (comp->h == jpeg->hMax && comp->v == jpeg->vMax)
+    {
+        memcpy(out, comp->plane + (size_t)y*comp->stride, jpeg->width);
+        return;
+    }
+    int fy = ((2*y + 1)*comp->v*128) / jpeg->vMax - 128;
+    int y0 = fy >> 8;
+    int wy = fy & 255;
+    int y1 = y0 + 1;
+    if (y0 < 0) y0 = 0;
+    if (y1 > comp->rows - 1) y1 = comp->rows - 1;
+    if (y0 > comp->rows - 1) y0 = comp->rows - 1;
+    const unsigned char *r0 = comp->plane + (size_t)y0*comp->stride;
+    const unsigned char *r1 = comp->plane + (size_t)y1*comp->stride;
+    for (int x = 0; x < jpeg->width; x++)
+    {
+        int x0 = comp->columnTaps[x*3];
+        int x1 = comp->columnTaps[x*3 + 1];
+        int wx = comp->columnTaps[x*3 + 2];
+        int top = r0[x0]*(256 - wx) + r0[x1]*wx;
+        int bottom = r1[x0]*(256 - wx) + r1[x1]*wx;
+        out[x] = (unsigned char)((top*(256 - wy) + bottom*wy + 32768) >> 16);
+    }
+}
+static void JpegColorConvertRow(unsigned char *dst, const unsigned char *yRow, const unsigned char *cbRow, const unsigned char *crRow, int width)
+{
+    int x = 0;
+#if defined(__SSE2__)
+    // 16 bit fixed point with two fraction bits, chroma scaled by 64 against constants scaled by 4096
+    __m128i zero = _mm_setzero_si128();
+    __m128i bias = _mm_set1_epi16(128);
+    __m128i round = _mm_set1_epi16(2);
+    __m128i crToR = _mm_set1_epi16(5743);
+    __m128i cbToG = _mm_set1_epi16(-1410);
+    __m128i crToG = _mm_set1_epi16(-2925);
+    __m128i cbToB = _mm_set1_epi16(7258);
+    __m128i alpha = _mm_set1_epi8((char)0xff);
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i yv = _mm_add_epi16(_mm_slli_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(yRow + x)), zero), 2), round);
+        __m128i cb = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(cbRow + x)), zero), bias), 6);
+        __m128i cr = _mm_slli_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(crRow + x)), zero), bias), 6);
+        __m128i r = _mm_srai_epi16(_mm_add_epi16(yv, _mm_mulhi_epi16(cr, crToR)), 2);
+        __m128i g = _mm_srai_epi16(_mm_add_epi16(yv, _mm_add_epi16(_mm_mulhi_epi16(cb, cbToG), _mm_mulhi_epi16(cr, crToG))), 2);
+        __m128i b = _mm_srai_epi16(_mm_add_epi16(yv, _mm_mulhi_epi16(cb, cbToB)), 2);
+        __m128i r8 = _mm_packus_epi16(r, r);
+        __m128i g8 = _mm_packus_epi16(g, g);
+        __m128i b8 = _mm_packus_epi16(b, b);
+        __m128i rg = _mm_unpacklo_epi8(r8, g8);
+        __m128i ba = _mm_unpacklo_epi8(b8, alpha);
+        _mm_storeu_si128((__m128i *)(dst + x*4), _mm_unpacklo_epi16(rg, ba));
+        _mm_storeu_si128((__m128i *)(dst + x*4 + 16), _mm_unpackhi_epi16(rg, ba));
+    }
+#endif
+    for (; x < width; x++)
+    {
+        int y = yRow[x]*4 + 2;
+        int cb = (cbRow[x] - 128)*64;
+        int cr = (crRow[x] - 128)*64;
+        dst[x*4] = JpegClamp((y + ((cr*5743) >> 16)) >> 2);
+        dst[x*4 + 1] = JpegClamp((y + ((cb*-1410) >> 16) + ((cr*-2925) >> 16)) >> 2);
+        dst[x*4 + 2] = JpegClamp((y + ((cb*7258) >> 16)) >> 2);
+        dst[x*4 + 3] = 255;
+    }
+}
+static void JpegConvertRows(void *ctx, int task)
+{
+    JpegDecoder *jpeg = ctx;
+    int first = task*JPEG_CONVERT_ROWS;
+    int last = first + JPEG_CONVERT_ROWS;
+    if (last > jpeg->height) last = jpeg->height;
+    unsigned char *rows = malloc((size_t)jpeg->width*3);
+    if (rows == NULL) { atomic_store(&jpeg->failed, 1); return; }
+    for (int y = first; y < last; y++)
+    {
+        unsigned char *dst = jpeg->pixels + (size_t)y*jpeg->width*4;
+        if (jpeg->componentCount == 1)
+        {
+            const unsigned char *src = jpeg->components[0].plane + (size_t)y*jpeg->components[0].stride;
+            for (int x = 0; x < jpeg->width; x++) ((unsigned int *)dst)[x] = src[x]*0x010101u | 0xff000000u;
+            continue;
+        }
+        for (int c = 0; c < 3; c++) JpegUpsampleRow(jpeg, &jpeg->components[c], y, rows + c*jpeg->width);
+        JpegColorConvertRow(dst, rows, rows + jpeg->width, rows + 2*jpeg->width, jpeg->width);
+    }
+    free(rows);
+}
+static int ReadBigEndian16(const unsigned char *p)
+{
+    return (p[0] << 8) | p[1];
+}
+bool DecodeJpegFast(const unsigned char *data, int size, Image *image)
+{
+    if (size < 4 || data[0] != 0xff || data[1] != 0xd8) return false;
+    JpegDecoder *jpeg = calloc(1, sizeof(JpegDecoder));
+    if (jpeg == NULL) return false;
+    atomic_init(&jpeg->failed, 0);
+
+    bool ok = false;
+    bool haveFrame = false;
+    const unsigned char *p = data + 2;
+    const unsigned char *end = data + size;
+    while (end - p >= 4)
+    {
+        if (p[0] != 0xff) break;
+        int marker = p[1];
+        if (marker == 0xff) { p++; continue; }
+        if (marker == 0xd9) break;
+        int length = ReadBigEndian16(p + 2);
+        const unsigned char *segment = p + 4;
+        if (length < 2 || length > end - p - 2) break;
+        const unsigned char *segmentEnd = p + 2 + length;
+
+        if (marker == 0xdb)
+        {
+            for (const unsigned char *q = segment; q < segmentEnd;)
+            {
+                int precision = q[0] >> 4;
+                int id = q[0] & 3;
+                q++;
+                if (segmentEnd - q < (precision ? 128 : 64)) break;
+                for (int i = 0; i < 64; i++, q += precision ? 2 : 1) jpeg->quant[id][i] = precision ? ReadBigEndian16(q) : q[0];
+            }
+        }
+        else if (marker == 0xc4)
+        {
+            for (const unsigned char *q = segment; segmentEnd - q >= 17;)
+            {
+                int tableClass = q[0] >> 4;
+                int id = q[0] & 3;
+                const unsigned char *counts = q + 1;
+                int total = 0;
+                for (int i = 0; i < 16; i++) total += counts[i];
+                q += 17;
+                if (total > 256 || segmentEnd - q < total || tableClass > 1) break;
+                if (!BuildJpegHuffman(&jpeg->huffman[tableClass*4 + id], counts, q, total)) goto done;
+                q += total;
+            }
+        }
+        else if (marker == 0xdd)
+        {
+            if (length >= 4) jpeg->restartInterval = ReadBigEndian16(segment);
+        }
+        else if (marker == 0xc0 || marker == 0xc1)
+        {
+            // baseline and extended huffman, 8 bit, grayscale or YCbCr
+            if (length < 8 || segment[0] != 8) goto done;
+            jpeg->height = ReadBigEndian16(segment + 1);
+            jpeg->width = ReadBigEndian16(segment + 3);
+            jpeg->componentCount = segment[5];
+            if (jpeg->width <= 0 || jpeg->height <= 0 || (jpeg->componentCount != 1 && jpeg->componentCount != 3)) goto done;
+            if (length < 8 + jpeg->componentCount*3) goto done;
+            jpeg->hMax = jpeg->vMax = 1;
+            for (int c = 0; c < jpeg->componentCount; c++)
+            {
+                JpegComponent *comp = &jpeg->components[c];
+                comp->id = segment[6 + c*3];
+                comp->h = segment[7 + c*3] >> 4;
+                comp->v = segment[7 + c*3] & 15;
+                comp->quantTable = segment[8 + c*3] & 3;
+                if (comp->h < 1 || comp->h > 4 || comp->v < 1 || comp->v > 4) goto done;
+                if (comp->h > jpeg->hMax) jpeg->hMax = comp->h;
+                if (comp->v > jpeg->vMax) jpeg->vMax = comp->v;
+            }
+            haveFrame = true;
+        }
+        else if ((marker >= 0xc2 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc) || marker == 0xee)
+        {
+            // progressive, lossless, arithmetic coded or Adobe transformed, stb_image handles those
+            goto done;
+        }
+        else if (marker == 0xda)
+        {
+            if (!haveFrame || segment[0] != jpeg->componentCount || length < 6 + jpeg->componentCount*2) goto done;
+            for (int i = 0; i < jpeg->componentCount; i++)
+            {
+                int id = segment[1 + i*2];
+                int tables = segment[2 + i*2];
+                int c = 0;
+                while (c < jpeg->componentCount && jpeg->components[c].id != id) c++;
+                if (c == jpeg->componentCount) goto done;
+                jpeg->components[c].dcTable = (tables >> 4) & 3;
+                jpeg->components[c].acTable = tables & 3;
+            }
+            // a lone component is not interleaved, its blocks run in raster order
+            if (jpeg->componentCount == 1) jpeg->components[0].h = jpeg->components[0].v = jpeg->hMax = jpeg->vMax = 1;
+            jpeg->mcusX = (jpeg->width + 8*jpeg->hMax - 1) / (8*jpeg->hMax);
+            jpeg->mcusY = (jpeg->height + 8*jpeg->vMax - 1) / (8*jpeg->vMax);
+            jpeg->mcuCount = jpeg->mcusX*jpeg->mcusY;
+            for (int c = 0; c < jpeg->componentCount; c++)
+            {
+                JpegComponent *comp = &jpeg->components[c];
+                comp->stride = jpeg->mcusX*comp->h*8;
+                comp->plane = malloc((size_t)comp->stride*jpeg->mcusY*comp->v*8);
+                if (comp->plane == NULL) goto done;
+                comp->columns = (jpeg->width*comp->h + jpeg->hMax - 1) / jpeg->hMax;
+                comp->rows = (jpeg->height*comp->v + jpeg->vMax - 1) / jpeg->vMax;
+                if (comp->h == jpeg->hMax && comp->v == jpeg->vMax) continue;
+
+                // horizontal taps are the same for every row, work them out once. vertical only subsampling (4:4:0) gets the identity
+                comp->columnTaps = malloc((size_t)jpeg->width*3*sizeof(int));
+                if (comp->columnTaps == NULL) goto done;
+                for (int x = 0; x < jpeg->width; x++)
+                {
+                    int fx = ((2*x + 1)*comp->h*128) / jpeg->hMax - 128;
+                    int x0 = fx >> 8;
+                    int x1 = x0 + 1;
+                    comp->columnTaps[x*3] = x0 < 0 ? 0 : x0;
+                    comp->columnTaps[x*3 + 1] = x1 > comp->columns - 1 ? comp->columns - 1 : x1;
+                    comp->columnTaps[x*3 + 2] = fx & 255;
+                }
+            }
+
+            // cut the entropy coded data at every restart marker
+            int capacity = 64;
+            jpeg->segments = malloc(capacity*sizeof(JpegSegment));
+            if (jpeg->segments == NULL) goto done;
+            const unsigned char *q = segmentEnd;
+            const unsigned char *start = q;
+            while (q < end - 1)
+            {
+                if (q[0] != 0xff || q[1] == 0x00 || q[1] == 0xff) { q++; continue; }
+                if (q[1] < 0xd0 || q[1] > 0xd7 || jpeg->restartInterval == 0) break;
+                if (jpeg->segmentCount + 1 >= capacity)
+                {
+                    capacity *= 2;
+                    JpegSegment *grown = realloc(jpeg->segments, capacity*sizeof(JpegSegment));
+                    if (grown == NULL) goto done;
+                    jpeg->segments = grown;
+                }
+                jpeg->segments[jpeg->segmentCount++] = (JpegSegment){ .start = start, .end = q };
+                q += 2;
+                start = q;
+            }
+            jpeg->segments[jpeg->segmentCount++] = (JpegSegment){ .start = start, .end = q };
+            // a truncated or padded scan is left to stb_image, it knows how to fill the gaps
+            if (jpeg->restartInterval > 0 && jpeg->segmentCount != (jpeg->mcuCount + jpeg->restartInterval - 1) / jpeg->restartInterval) goto done;
+
+            jpeg->pixels = malloc((size_t)jpeg->width*jpeg->height*4);
+            if (jpeg->pixels == NULL) goto done;
+            int tasks = GetWorkerCount()*4;
+            jpeg->intervalsPerTask = (jpeg->segmentCount + tasks - 1) / tasks;
+            tasks = (jpeg->segmentCount + jpeg->intervalsPerTask - 1) / jpeg->intervalsPerTask;
+            ParallelFor(tasks, JpegDecodeInterval, jpeg);
+            if (atomic_load(&jpeg->failed)) goto done;
+            ParallelFor((jpeg->height + JPEG_CONVERT_ROWS - 1) / JPEG_CONVERT_ROWS, JpegConvertRows, jpeg);
+            ok = !atomic_load(&jpeg->failed);
+            break;
+        }
+        p = segmentEnd;
+    }
+
+done:
+    for (int c = 0; c < 3; c++)
+    {
+        free(jpeg->components[c].plane);
+        free(jpeg->components[c].columnTaps);
+    }
+    free(jpeg->segments);
+    if (ok) *image = (Image){ .data = jpeg->pixels, .width = jpeg->width, .height = jpeg->height, .mipmaps = 1, .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    else free(jpeg->pixels);
+    free(jpeg);
+    return ok;
+}
+Image LoadImageFromMemoryFast(const char *fileType, const unsigned char *data, int size)
+{
+    Image image = { 0 };
+    if (DecodePngFast(data, size, &image) || DecodeJpegFast(data, size, &image)) return image;
+    // formats and features the fast paths skip still go through stb_image
+    image = LoadImageFromMemory(fileType, data, size);
+    if (image.data != NULL) ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return image;
+}
+Image LoadBackgroundImage(const char *fileName)
+{
+    int size = 0;
+    unsigned char *data = LoadFileData(fileName, &size);
+    if (data == NULL) return (Image){ 0 };
+    Image image = LoadImageFromMemoryFast(GetFileExtension(fileName), data, size);
+    UnloadFileData(data);
+    return image;
+}
+static int CompareSeconds(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+static double MedianSeconds(double *samples, int count)
+{
+    qsort(samples, count, sizeof(double), CompareSeconds);
+    return samples[count/2];
+}
+// 24x20 baseline jpeg with vertical only chroma subsampling (Y 1x2, Cb/Cr 1x1), cameras and phones write it and it's easy to get wrong
+static const unsigned char jpegSample440[] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x84, 0x00, 0x03, 0x02, 0x02, 0x03, 0x05, 0x08, 0x0a, 0x0c, 0x02, 0x02, 0x03, 0x04, 0x05,
+    0x0c, 0x0c, 0x0b, 0x03, 0x03, 0x03, 0x05, 0x08, 0x0b, 0x0e, 0x0b, 0x03, 0x03, 0x04, 0x06, 0x0a, 0x11, 0x10, 0x0c, 0x04,
+    0x04, 0x07, 0x0b, 0x0e, 0x16, 0x15, 0x0f, 0x05, 0x07, 0x0b, 0x0d, 0x10, 0x15, 0x17, 0x12, 0x0a, 0x0d, 0x10, 0x11, 0x15,
+    0x18, 0x18, 0x14, 0x0e, 0x12, 0x13, 0x14, 0x16, 0x14, 0x15, 0x14, 0x01, 0x03, 0x04, 0x05, 0x09, 0x14, 0x14, 0x14, 0x14,
+    0x04, 0x04, 0x05, 0x0d, 0x14, 0x14, 0x14, 0x14, 0x05, 0x05, 0x0b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x09, 0x0d, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0xff, 0xc0, 0x00, 0x11,
+    0x08, 0x00, 0x14, 0x00, 0x18, 0x03, 0x01, 0x12, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff, 0xc4, 0x01, 0xa2, 0x00,
+    0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03,
+    0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04,
+    0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61,
+    0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62,
+    0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38,
+    0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64,
+    0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa,
+    0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3,
+    0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3,
+    0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x11, 0x00, 0x02, 0x01,
+    0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05,
+    0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1,
+    0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a,
+    0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53,
+    0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+    0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2,
+    0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4,
+    0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03,
+    0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0xee, 0xfc, 0x25, 0xfb, 0x60, 0xda, 0xf9, 0x1d, 0x17, 0xa7, 0xf4,
+    0xac, 0xbf, 0x09, 0x7e, 0xc6, 0x53, 0x79, 0x1d, 0xfa, 0x7f, 0x4a, 0xfc, 0x2f, 0x0b, 0x94, 0x64, 0xdc, 0xdf, 0x11, 0xfb,
+    0xb6, 0x49, 0x4f, 0x20, 0xf6, 0x5f, 0xc5, 0x7b, 0x1e, 0x79, 0xe3, 0xef, 0xdb, 0x06, 0xd7, 0xcd, 0xe8, 0xbd, 0x6b, 0x2b,
+    0xc7, 0xdf, 0xb1, 0x94, 0xde, 0x6f, 0x7e, 0xb5, 0xfd, 0x3b, 0xc2, 0xf9, 0x46, 0x4d, 0x65, 0xef, 0x1f, 0xc7, 0x3c, 0x7f,
+    0x4f, 0x20, 0xe7, 0xfe, 0x2b, 0xdc, 0xf6, 0x7f, 0x83, 0x9f, 0xb6, 0x0d, 0xae, 0xd1, 0xc2, 0xd7, 0x37, 0xf0, 0xdb, 0xf6,
+    0x42, 0x9a, 0x08, 0x72, 0xa4, 0xee, 0xff, 0x00, 0x57, 0x0f, 0xfd, 0x74, 0x61, 0xf4, 0x3f, 0x74, 0x73, 0x5e, 0xf7, 0x11,
+    0x7f, 0xab, 0xf4, 0x20, 0xea, 0x66, 0x98, 0x8e, 0x58, 0xaf, 0x76, 0x0b, 0xad, 0x49, 0x74, 0x8c, 0x57, 0x59, 0x3f, 0xb9,
+    0x2b, 0xb6, 0xd4, 0x53, 0x6b, 0xf5, 0x9f, 0x0c, 0xa8, 0x64, 0x2d, 0x25, 0x0a, 0x8f, 0xfc, 0x8f, 0xa1, 0x3c, 0x25, 0xf1,
+    0x1b, 0x59, 0xf2, 0x3f, 0xd7, 0xc5, 0xd3, 0xfb, 0xbe, 0xdf, 0x5a, 0xe6, 0x3c, 0x25, 0xfe, 0xa3, 0xf0, 0xfe, 0x95, 0xfc,
+    0xd3, 0x85, 0xc2, 0x52, 0xe6, 0xff, 0x00, 0x76, 0xa5, 0xf7, 0x1f, 0x67, 0x92, 0x61, 0x29, 0x7b, 0x2f, 0xf7, 0x6a, 0x5b,
+    0x76, 0x38, 0xef, 0x1f, 0x7c, 0x46, 0xd6, 0x7c, 0xdf, 0xf5, 0xf1, 0x75, 0xfe, 0xef, 0xff, 0x00, 0x5e, 0xb9, 0x8f, 0x1f,
+    0x7f, 0xad, 0xfc, 0x6b, 0xfa, 0x7b, 0x85, 0xf0, 0x94, 0xac, 0xbf, 0xd9, 0xa9, 0x7d, 0xc7, 0xf1, 0xcf, 0x1f, 0xe1, 0x29,
+    0x73, 0xff, 0x00, 0xbb, 0x52, 0xdf, 0xb1, 0xe8, 0x9e, 0x06, 0xf8, 0x9d, 0xae, 0x34, 0x98, 0x7b, 0x88, 0xb6, 0xa8, 0x0a,
+    0x8b, 0x83, 0xfc, 0x4a, 0x0e, 0x48, 0xcf, 0x72, 0x6b, 0x93, 0xf0, 0x0f, 0xfa, 0xd6, 0xff, 0x00, 0x80, 0xff, 0x00, 0xe8,
+    0xb5, 0xaf, 0xe4, 0x8f, 0x17, 0x20, 0x9e, 0x2e, 0xa4, 0x6b, 0x42, 0x2d, 0x41, 0x42, 0x9e, 0x1a, 0x3d, 0x20, 0x9d, 0x38,
+    0xc9, 0xdb, 0xd5, 0xb6, 0xd9, 0xfb, 0xe7, 0x85, 0x38, 0x2a, 0x3c, 0x8a, 0xd8, 0x5a, 0x5d, 0xde, 0x9b, 0x9f, 0xff, 0xd9,
+};
+int RunDecodeBenchmark(const char *directory, int iterations)
+{
+    // every png and jpeg in the directory, stb_image to RGBA8 against the fast path, median of the runs. the built in sample goes first
+    FilePathList files = LoadDirectoryFiles(directory);
+    if (iterations < 1) iterations = 1;
+    double *samples = malloc(iterations*sizeof(double));
+    double totalStb = 0.0, totalFast = 0.0, totalPixels = 0.0;
+    int decoded = 0;
+    printf("%-40s %11s %10s %10s %8s %8s\n", "file", "size", "stb ms", "fast ms", "speedup", "maxdiff");
+    for (int i = -1; i < (int)files.count; i++)
+    {
+        bool sample = i < 0;
+        const char *path = sample ? "4:4:0 sample" : files.paths[i];
+        if (!sample && !IsFileExtension(path, ".png;.jpg;.jpeg")) continue;
+        int size = sample ? (int)sizeof(jpegSample440) : 0;
+        unsigned char *data = sample ? (unsigned char *)jpegSample440 : LoadFileData(path, &size);
+        if (data == NULL) continue;
+        const char *extension = sample ? ".jpg" : GetFileExtension(path);
+
+        Image reference = { 0 };
+        for (int run = 0; run < iterations; run++)
+        {
+            UnloadImage(reference);
+            double start = ClockSeconds();
+            reference = LoadImageFromMemory(extension, data, size);
+            ImageFormat(&reference, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            samples[run] = ClockSeconds() - start;
+        }
+        double stbTime = MedianSeconds(samples, iterations);
+
+        Image image = { 0 };
+        for (int run = 0; run < iterations; run++)
+        {
+            UnloadImage(image);
+            double start = ClockSeconds();
+            image = LoadImageFromMemoryFast(extension, data, size);
+            samples[run] = ClockSeconds() - start;
+        }
+        double fastTime = MedianSeconds(samples, iterations);
+
+        int maxDiff = -1;
+        if (reference.data != NULL && image.data != NULL && reference.width == image.width && reference.height == image.height)
+        {
+            maxDiff = 0;
+            const unsigned char *a = reference.data;
+            const unsigned char *b = image.data;
+            for (size_t p = 0; p < (size_t)image.width*image.height*4; p++)
+            {
+                int diff = abs(a[p] - b[p]);
+                if (diff > maxDiff) maxDiff = diff;
+            }
+        }
+        printf("%-40s %5dx%-5d %10.2f %10.2f %7.2fx %8d\n", GetFileName(path), image.width, image.height,
+               stbTime*1000.0, fastTime*1000.0, fastTime > 0.0 ? stbTime/fastTime : 0.0, maxDiff);
+        if (image.data != NULL && !sample)
+        {
+            totalStb += stbTime;
+            totalFast += fastTime;
+            totalPixels += (double)image.width*image.height;
+            decoded++;
+        }
+        UnloadImage(reference);
+        UnloadImage(image);
+        if (!sample) UnloadFileData(data);
+    }
+    if (decoded > 0)
+        printf("%d images, stb %.1f MP/s, fast %.1f MP/s, %.2fx\n", decoded, totalPixels/totalStb*1e-6, totalPixels/totalFast*1e-6, totalStb/totalFast);
+    free(samples);
+    UnloadDirectoryFiles(files);
+    return decoded > 0 ? 0 : 1;
+}
+#pragma endregion
+#pragma region Jobs
+#if !defined(PLATFORM_WEB)
+static _Thread_local int jobWorkerIndex = -1;   // which deque a job submitted from inside a job goes to
+static bool PushJob(JobWorker *worker, Job *job)
+{
+    pthread_mutex_lock(&worker->lock);
+    bool pushed = worker->bottom - worker->top < JOB_DEQUE_SIZE;
+    if (pushed) worker->jobs[worker->bottom++ & (JOB_DEQUE_SIZE - 1)] = job;
+    pthread_mutex_unlock(&worker->lock);
+    return pushed;
+}
+static Job *PopJob(JobWorker *worker)
+{
+    // the owner takes the newest job, whatever it touched is still in cache
+    pthread_mutex_lock(&worker->lock);
+    Job *job = worker->bottom > worker->top ? worker->jobs[--worker->bottom & (JOB_DEQUE_SIZE - 1)] : NULL;
+    pthread_mutex_unlock(&worker->lock);
+    return job;
+}
+static Job *StealJob(JobWorker *worker)
+{
+    // thieves take the oldest from the other end
+    pthread_mutex_lock(&worker->lock);
+    Job *job = worker->bottom > worker->top ? worker->jobs[worker->top++ & (JOB_DEQUE_SIZE - 1)] : NULL;
+    pthread_mutex_unlock(&worker->lock);
+    return job;
+}
+static void FinishJob(Job *job)
+{
+    // finished jobs go on a lock free stack, the main thread takes the whole stack at once
+    job->next = atomic_load(&jobs.finished);
+    while (!atomic_compare_exchange_weak(&jobs.finished, &job->next, job));
+}
+static void *JobWorkerThread(void *arg)
+{
+    int index = (int)(intptr_t)arg;
+    JobWorker *self = &jobs.workers[index];
+    jobWorkerIndex = index;
+    while (true)
+    {
+        Job *job = PopJob(self);
+        for (int i = 1; job == NULL && i < jobs.workerCount; i++)
+        {
+            job = StealJob(&jobs.workers[(index + i) % jobs.workerCount]);
+            if (job != NULL) atomic_fetch_add(&jobs.steals, 1);
+        }
+        if (job == NULL)
+        {
+            // the submitter counts a job before it signals, so checking under the lock never misses one
+            pthread_mutex_lock(&jobs.sleepLock);
+            while (atomic_load(&jobs.queued) == 0 && !atomic_load(&jobs.quit)) pthread_cond_wait(&jobs.wake, &jobs.sleepLock);
+            pthread_mutex_unlock(&jobs.sleepLock);
+            if (atomic_load(&jobs.queued) == 0 && atomic_load(&jobs.quit)) return NULL;
+            continue;
+        }
+        atomic_fetch_sub(&jobs.queued, 1);
+        atomic_fetch_add(&jobs.running, 1);
+        double start = ClockSeconds();
+        if (job->run != NULL) job->run(job->data);
+        atomic_fetch_add(&self->busyNanos, (unsigned long long)((ClockSeconds() - start)*1e9));
+        atomic_fetch_sub(&jobs.running, 1);
+        FinishJob(job);
+    }
+}
+#endif
+void InitJobSystem()
+{
+#if !defined(PLATFORM_WEB)
+    // the main thread only runs completions, leave it a core
+    int count = GetWorkerCount() - 1;
+    if (count < 1) count = 1;
+    pthread_mutex_init(&jobs.sleepLock, NULL);
+    pthread_cond_init(&jobs.wake, NULL);
+    atomic_store(&jobs.quit, false);
+    for (int i = 0; i < count; i++)
+    {
+        pthread_mutex_init(&jobs.workers[i].lock, NULL);
+        jobs.workers[i].top = jobs.workers[i].bottom = 0;
+        atomic_store(&jobs.workers[i].busyNanos, 0);
+    }
+    // every deque exists before the first worker looks for one to steal from, a worker that failed to start only leaves its deque to the thieves
+    jobs.workerCount = count;
+    int started = 0;
+    for (int i = 0; i < count; i++)
+    {
+        jobs.workers[i].started = pthread_create(&jobs.workers[i].thread, NULL, JobWorkerThread, (void *)(intptr_t)i) == 0;
+        if (jobs.workers[i].started) started++;
+    }
+    jobs.sampleTime = ClockSeconds();
+    if (started == 0)
+    {
+        TraceLog(LOG_WARNING, "JOBS: No worker threads, jobs run on the main thread");
+        for (int i = 0; i < count; i++) pthread_mutex_destroy(&jobs.workers[i].lock);
+        jobs.workerCount = 0;
+    }
+#endif
+}
+void SubmitJob(JobFunction run, JobFunction complete, void *data)
+{
+    // run on a worker, complete on the main thread from PollJobs, either may be NULL
+#if !defined(PLATFORM_WEB)
+    if (jobs.workerCount > 0)
+    {
+        Job *job = malloc(sizeof(Job));
+        *job = (Job){ .run = run, .complete = complete, .data = data };
+        atomic_fetch_add(&jobs.submitted, 1);
+        // jobs from the main thread are dealt round the deques, stealing evens out the rest
+        int first = jobWorkerIndex >= 0 ? jobWorkerIndex : jobs.nextWorker++ % jobs.workerCount;
+        // counted before it is visible, a worker that takes it straight away must not take the count below zero
+        atomic_fetch_add(&jobs.queued, 1);
+        bool pushed = false;
+        for (int i = 0; i < jobs.workerCount && !pushed; i++) pushed = PushJob(&jobs.workers[(first + i) % jobs.workerCount], job);
+        if (pushed)
+        {
+            pthread_mutex_lock(&jobs.sleepLock);
+            pthread_cond_signal(&jobs.wake);
+            pthread_mutex_unlock(&jobs.sleepLock);
+            return;
+        }
+        // every deque full, do it here rather than drop it, a worker still leaves the completion to the main thread
+        atomic_fetch_sub(&jobs.queued, 1);
+        if (run != NULL) run(data);
+        if (jobWorkerIndex >= 0)
+        {
+            FinishJob(job);
+            return;
+        }
+        atomic_fetch_sub(&jobs.submitted, 1);
+        free(job);
+        if (complete != NULL) complete(data);
+        return;
+    }
+#endif
+    if (run != NULL) run(data);
+    if (complete != NULL) complete(data);
+}
+void PollJobs(double budget)
+{
+#if !defined(PLATFORM_WEB)
+    if (jobs.workerCount == 0) return;
+    // the stack comes newest first, reversed onto the queue so completions run in finishing order
+    Job *finished = atomic_exchange(&jobs.finished, NULL);
+    Job *reversed = NULL;
+    while (finished != NULL)
+    {
+        Job *next = finished->next;
+        finished->next = reversed;
+        reversed = finished;
+        finished = next;
+    }
+    if (reversed != NULL)
+    {
+        if (jobs.completionTail != NULL) jobs.completionTail->next = reversed;
+        else jobs.completions = reversed;
+        while (reversed != NULL)
+        {
+            jobs.completionTail = reversed;
+            jobs.completionCount++;
+            reversed = reversed->next;
+        }
+    }
+    // at least one a frame, the rest wait for the next frame once the budget is gone
+    double start = ClockSeconds();
+    while (jobs.completions != NULL)
+    {
+        Job *job = jobs.completions;
+        jobs.completions = job->next;
+        if (jobs.completions == NULL) jobs.completionTail = NULL;
+        jobs.completionCount--;
+        if (job->complete != NULL) job->complete(job->data);
+        free(job);
+        jobs.completed++;
+        if (ClockSeconds() - start > budget) break;
+    }
+
+    double now = ClockSeconds();
+    if (now - jobs.sampleTime >= JOB_SAMPLE_SECONDS)
+    {
+        unsigned long long busy = 0;
+        for (int i = 0; i < jobs.workerCount; i++) busy += atomic_load(&jobs.workers[i].busyNanos);
+        jobs.utilization = (float)((busy - jobs.sampleBusy)*1e-9/((now - jobs.sampleTime)*jobs.workerCount));
+        jobs.sampleBusy = busy;
+        jobs.sampleTime = now;
+    }
+#endif
+}
+void ShutdownJobSystem()
+{
+#if !defined(PLATFORM_WEB)
+    if (jobs.workerCount == 0) return;
+    // everything submitted still completes, a round that ends as the window closes is still saved
+    while (jobs.completed != atomic_load(&jobs.submitted))
+    {
+        PollJobs(1.0);
+        if (jobs.completed != atomic_load(&jobs.submitted)) usleep(1000);
+    }
+    pthread_mutex_lock(&jobs.sleepLock);
+    atomic_store(&jobs.quit, true);
+    pthread_cond_broadcast(&jobs.wake);
+    pthread_mutex_unlock(&jobs.sleepLock);
+    for (int i = 0; i < jobs.workerCount; i++)
+    {
+        if (jobs.workers[i].started) pthread_join(jobs.workers[i].thread, NULL);
+        pthread_mutex_destroy(&jobs.workers[i].lock);
+    }
+    pthread_mutex_destroy(&jobs.sleepLock);
+    pthread_cond_destroy(&jobs.wake);
+    jobs.workerCount = 0;
+#endif
+}
+#if !defined(PLATFORM_WEB)
+static void RunParallelTasks(ParallelJob *job)
+{
+    for (int i = atomic_fetch_add(&job->next, 1); i < job->count; i = atomic_fetch_add(&job->next, 1))
+    {
+        job->task(job->ctx, i);
+        atomic_fetch_add_explicit(&job->done, 1, memory_order_release);
+    }
+}
+static void ReleaseParallelJob(ParallelJob *job)
+{
+    if (atomic_fetch_sub(&job->refs, 1) == 1) free(job);
+}
+static void ParallelHelperJob(void *data)
+{
+    // a helper that starts after the last index was taken only lets go of the job
+    RunParallelTasks(data);
+    ReleaseParallelJob(data);
+}
+#endif
+void ParallelFor(int count, ParallelTask task, void *ctx)
+{
+#if !defined(PLATFORM_WEB)
+    // helpers are jobs, the caller takes part and only ever waits on an index somebody is already running
+    int helpers = jobs.workerCount - (jobWorkerIndex >= 0);
+    if (helpers > count - 1) helpers = count - 1;
+    ParallelJob *job = helpers > 0 ? malloc(sizeof(ParallelJob)) : NULL;
+    if (job != NULL)
+    {
+        *job = (ParallelJob){ .task = task, .ctx = ctx, .count = count };
+        atomic_init(&job->next, 0);
+        atomic_init(&job->done, 0);
+        atomic_init(&job->refs, helpers + 1);
+        for (int i = 0; i < helpers; i++) SubmitJob(ParallelHelperJob, NULL, job);
+        RunParallelTasks(job);
+        while (atomic_load_explicit(&job->done, memory_order_acquire) < count) sched_yield();
+        ReleaseParallelJob(job);
+        return;
+    }
+#endif
+    for (int i = 0; i < count; i++) task(ctx, i);
+}
+void DrawJobStats()
+{
+    if (!renderStats.showOverlay) return;
+#if !defined(PLATFORM_WEB)
+    DrawUiText(TextFormat("jobs  queued %d  running %d  completing %d  workers %d  busy %d%%  steals %u", atomic_load(&jobs.queued),
+             atomic_load(&jobs.running), jobs.completionCount, jobs.workerCount, (int)(jobs.utilization*100.0f), atomic_load(&jobs.steals)),
+             4, screenHeight - 84, 10, GRAY);
+#else
+    DrawUiText("jobs run on the main thread in the web build", 4, screenHeight - 84, 10, GRAY);
+#endif
+}
+#pragma endregion
+#pragma region Clipboard
+bool DecodeBmpToRgba(const unsigned char *data, int size, Image *image)
+{
+    // clipboards hand out whole .bmp files or bare DIBs, both are raw pixels we can swizzle straight into the upload buffer
+    if (size >= 14 && data[0] == 'B' && data[1] == 'M')
+    {
+        data += 14;
+        size -= 14;
+    }
+    if (size < 40) return false;
+    unsigned int headerSize = data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int)data[3] << 24);
+    int width = (int)(data[4] | (data[5] << 8) | (data[6] << 16) | ((unsigned int)data[7] << 24));
+    int height = (int)(data[8] | (data[9] << 8) | (data[10] << 16) | ((unsigned int)data[11] << 24));
+    int bitCount = data[14] | (data[15] << 8);
+    int compression = (int)(data[16] | (data[17] << 8) | (data[18] << 16) | ((unsigned int)data[19] << 24));
+    if (headerSize < 40 || headerSize > (unsigned int)size || width <= 0 || width > 32768 || height == 0 || height < -32768 || height > 32768) return false;
+    if (!((bitCount == 24 && compression == 0) || (bitCount == 32 && (compression == 0 || compression == 3)))) return false;
+
+    // bitfield masks follow a plain info header, bigger headers carry them inline
+    int offset = headerSize + (compression == 3 && headerSize == 40 ? 12 : 0);
+    unsigned int masks[3] = { 0x00ff0000, 0x0000ff00, 0x000000ff };
+    if (compression == 3)
+    {
+        if (offset > size) return false;
+        for (int i = 0; i < 3; i++) masks[i] = data[40 + i*4] | (data[41 + i*4] << 8) | (data[42 + i*4] << 16) | ((unsigned int)data[43 + i*4] << 24);
+    }
+    int shifts[3];
+    for (int i = 0; i < 3; i++)
+    {
+        if (masks[i] == 0) return false;
+        shifts[i] = __builtin_ctz(masks[i]);
+        if ((masks[i] >> shifts[i]) != 0xff) return false;
+    }
+
+    bool topDown = height < 0;
+    if (topDown) height = -height;
+    int bytesPerPixel = bitCount/8;
+    size_t rowStride = ((size_t)width*bytesPerPixel + 3) & ~(size_t)3;
+    if ((size_t)offset + rowStride*height > (size_t)size) return false;
+    unsigned int *pixels = malloc((size_t)width*height*4);
+    if (pixels == NULL) return false;
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *src = data + offset + rowStride*(topDown ? y : height - 1 - y);
+        unsigned int *dst = pixels + (size_t)y*width;
+        if (bitCount == 24)
+        {
+            for (int x = 0; x < width; x++, src += 3) dst[x] = src[2] | (src[1] << 8) | (src[0] << 16) | 0xff000000u;
+        }
+        else
+        {
+            // backgrounds are opaque, clipboard alpha is unreliable anyway
+            for (int x = 0; x < width; x++, src += 4)
+            {
+                unsigned int p = src[0] | (src[1] << 8) | (src[2] << 16) | ((unsigned int)src[3] << 24);
+                dst[x] = ((p >> shifts[0]) & 0xff) | (((p >> shifts[1]) & 0xff) << 8) | (((p >> shifts[2]) & 0xff) << 16) | 0xff000000u;
+            }
+        }
+    }
+    *image = (Image){ .data = pixels, .width = width, .height = height, .mipmaps = 1, .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    return true;
+}
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+// raw pixels first, then formats the fast decoder handles
+static const char *clipboardImageTypes[] = { "image/bmp", "image/x-bmp", "image/x-MS-bmp", "image/png", "image/jpeg" };
+#define NUM_CLIPBOARD_IMAGE_TYPES (int)(sizeof(clipboardImageTypes)/sizeof(clipboardImageTypes[0]))
+
+static Image DecodeClipboardBytes(const char *mimeType, const unsigned char *data, int size)
+{
+    Image image = { 0 };
+    if (strstr(mimeType, "bmp") != NULL && DecodeBmpToRgba(data, size, &image)) return image;
+    return LoadImageFromMemoryFast(strstr(mimeType, "png") != NULL ? ".png" : strstr(mimeType, "bmp") != NULL ? ".bmp" : ".jpg", data, size);
+}
+
+static bool WaitForX11Event(Display *display, Window window, int type, XEvent *event, double timeout)
+{
+    double deadline = ClockSeconds() + timeout;
+    for (;;)
+    {
+        while (XPending(display) > 0)
+        {
+            XNextEvent(display, event);
+            if (event->type == type && event->xany.window == window) return true;
+        }
+        double left = deadline - ClockSeconds();
+        if (left <= 0.0) return false;
+        struct pollfd fd = { ConnectionNumber(display), POLLIN, 0 };
+        poll(&fd, 1, (int)(left*1000.0) + 1);
+    }
+}
+static unsigned char *ReadX11Selection(Display *display, Window window, Atom selection, Atom target, int *size, Atom *type)
+{
+    Atom property = XInternAtom(display, "INCOGNITOAIM_CLIP", False);
+    Atom incr = XInternAtom(display, "INCR", False);
+    XConvertSelection(display, selection, target, property, window, CurrentTime);
+    XEvent event;
+    if (!WaitForX11Event(display, window, SelectionNotify, &event, CLIPBOARD_TIMEOUT) || event.xselection.property == None) return NULL;
+
+    int format;
+    unsigned long count, after;
+    unsigned char *chunk = NULL;
+    if (XGetWindowProperty(display, window, property, 0, LONG_MAX/4, True, AnyPropertyType, type, &format, &count, &after, &chunk) != Success) return NULL;
+
+    // format 32 properties come back as longs whatever the server stored
+    size_t unit = format == 32 ? sizeof(long) : format/8;
+    unsigned char *result = NULL;
+    size_t total = 0;
+    if (*type != incr)
+    {
+        total = count*unit;
+        result = malloc(total > 0 ? total : 1);
+        if (result != NULL) memcpy(result, chunk, total);
+        XFree(chunk);
+    }
+    else
+    {
+        // big selections arrive in pieces, deleting each property asks the owner for the next one
+        XFree(chunk);
+        for (;;)
+        {
+            do
+            {
+                if (!WaitForX11Event(display, window, PropertyNotify, &event, CLIPBOARD_TIMEOUT)) { free(result); return NULL; }
+            } while (event.xproperty.atom != property || event.xproperty.state != PropertyNewValue);
+            if (XGetWindowProperty(display, window, property, 0, LONG_MAX/4, True, AnyPropertyType, type, &format, &count, &after, &chunk) != Success) { free(result); return NULL; }
+            size_t length = count*(format == 32 ? sizeof(long) : format/8);
+            if (length == 0) { XFree(chunk); break; }
+            unsigned char *grown = realloc(result, total + length);
+            if (grown == NULL) { XFree(chunk); free(result); return NULL; }
+            result = grown;
+            memcpy(result + total, chunk, length);
+            total += length;
+            XFree(chunk);
+        }
+    }
+    if (result != NULL && total > INT_MAX) { free(result); return NULL; }
+    *size = (int)total;
+    return result;
+}
+static Image LoadClipboardImageX11()
+{
+    Image image = { 0 };
+    Display *display = XOpenDisplay(NULL);
+    if (display == NULL) return image;
+    Atom selection = XInternAtom(display, "CLIPBOARD", False);
+    if (XGetSelectionOwner(display, selection) == None)
+    {
+        XCloseDisplay(display);
+        return image;
+    }
+    // our own invisible window receives the transfer, the raylib window is left alone
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+    XSelectInput(display, window, PropertyChangeMask);
+
+    Atom type;
+    int size = 0;
+    Atom *offered = (Atom *)ReadX11Selection(display, window, selection, XInternAtom(display, "TARGETS", False), &size, &type);
+    int offeredCount = offered != NULL ? size/(int)sizeof(Atom) : 0;
+    for (int i = 0; i < NUM_CLIPBOARD_IMAGE_TYPES && image.data == NULL; i++)
+    {
+        Atom target = XInternAtom(display, clipboardImageTypes[i], False);
+        bool available = false;
+        for (int j = 0; j < offeredCount; j++) available = available || offered[j] == target;
+        if (!available) continue;
+        unsigned char *data = ReadX11Selection(display, window, selection, target, &size, &type);
+        if (data == NULL) continue;
+        image = DecodeClipboardBytes(clipboardImageTypes[i], data, size);
+        free(data);
+    }
+    free(offered);
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+    return image;
+}
+static unsigned char *ReadCommandOutput(const char *command, int *size)
+{
+    FILE *pipe = popen(command, "r");
+    if (pipe == NULL) return NULL;
+    size_t capacity = 1 << 20;
+    size_t total = 0;
+    unsigned char *data = malloc(capacity);
+    while (data != NULL)
+    {
+        if (total == capacity)
+        {
+            unsigned char *grown = realloc(data, capacity*2);
+            if (grown == NULL) { free(data); data = NULL; break; }
+            data = grown;
+            capacity *= 2;
+        }
+        size_t got = fread(data + total, 1, capacity - total, pipe);
+        if (got == 0) break;
+        total += got;
+    }
+    if (pclose(pipe) != 0 || total == 0 || total > INT_MAX)
+    {
+        free(data);
+        return NULL;
+    }
+    *size = (int)total;
+    return data;
+}
+static Image LoadClipboardImageWayland()
+{
+    // wayland only lets focused clients read the clipboard directly, wl-paste does the protocol dance for us
+    Image image = { 0 };
+    int size = 0;
+    char *types = (char *)ReadCommandOutput("wl-paste --list-types 2>/dev/null", &size);
+    if (types == NULL) return image;
+    char *terminated = realloc(types, size + 1);
+    if (terminated == NULL) { free(types); return image; }
+    types = terminated;
+    types[size] = '\0';
+    for (int i = 0; i < NUM_CLIPBOARD_IMAGE_TYPES && image.data == NULL; i++)
+    {
+        const char *found = strstr(types, clipboardImageTypes[i]);
+        size_t length = strlen(clipboardImageTypes[i]);
+        if (found == NULL || (found[length] != '\n' && found[length] != '\0')) continue;
+        // runs on a job worker, TextFormat's buffers belong to the main thread
+        char command[128];
+        snprintf(command, sizeof(command), "wl-paste --no-newline --type %s 2>/dev/null", clipboardImageTypes[i]);
+        unsigned char *data = ReadCommandOutput(command, &size);
+        if (data == NULL) continue;
+        image = DecodeClipboardBytes(clipboardImageTypes[i], data, size);
+        free(data);
+    }
+    free(types);
+    return image;
+}
+#endif
+Image LoadClipboardImage()
+{
+    Image image = { 0 };
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    if (getenv("WAYLAND_DISPLAY") != NULL) image = LoadClipboardImageWayland();
+    if (image.data == NULL && getenv("DISPLAY") != NULL) image = LoadClipboardImageX11();
+#else
+    image = GetClipboardImage();
+    if (image.data != NULL) ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+#endif
+    if (image.data == NULL) TraceLog(LOG_INFO, "CLIPBOARD: No image on the clipboard");
+    return image;
+}
+#pragma endregion
+#pragma region Background Compression
+unsigned long long HashPixels(Image image)
+{
+    // four independent lanes keep this at memory speed, it only has to tell screenshots apart
+    size_t size = GetPixelDataSize(image.width, image.height, image.format);
+    const unsigned char *data = image.data;
+    unsigned long long lanes[4] = { (unsigned long long)image.width, (unsigned long long)image.height, (unsigned long long)image.format, size };
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        for (int l = 0; l < 4; l++)
+        {
+            unsigned long long v;
+            memcpy(&v, data + i + l*8, 8);
+            lanes[l] = (lanes[l] ^ v)*0x9E3779B97F4A7C15ull;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+    unsigned long long hash = lanes[0] ^ (lanes[1]*31) ^ (lanes[2]*961) ^ (lanes[3]*29791);
+    for (; i < size; i++) hash = (hash ^ data[i])*0x100000001B3ull;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return hash;
+}
+static unsigned short PackRgb565(const int *rgb)
+{
+    return (unsigned short)(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+}
+static void UnpackRgb565(unsigned short color, int *rgb)
+{
+    int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+static int PickBc1Indices(const unsigned char *pixels, unsigned short *c0, unsigned short *c1, unsigned int *indices)
+{
+    // c0 > c1 selects the four color mode, returns the squared error of the block
+    if (*c0 < *c1) { unsigned short t = *c0; *c0 = *c1; *c1 = t; }
+    *indices = 0;
+    int palette[4][3];
+    UnpackRgb565(*c0, palette[0]);
+    UnpackRgb565(*c1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+        palette[2][c] = (2*palette[0][c] + palette[1][c] + 1)/3;
+        palette[3][c] = (palette[0][c] + 2*palette[1][c] + 1)/3;
+    }
+    int colors = *c0 == *c1 ? 1 : 4;
+    int error = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int best = 0, bestDistance = INT_MAX;
+        for (int p = 0; p < colors; p++)
+        {
+            int dr = pixels[i*4] - palette[p][0], dg = pixels[i*4 + 1] - palette[p][1], db = pixels[i*4 + 2] - palette[p][2];
+            int distance = dr*dr + dg*dg + db*db;
+            if (distance < bestDistance) { bestDistance = distance; best = p; }
+        }
+        *indices |= (unsigned int)best << (2*i);
+        error += bestDistance;
+    }
+    return error;
+}
+static bool RefineBc1Endpoints(const unsigned char *pixels, unsigned int indices, int *hi, int *lo)
+{
+    // least squares endpoints for the chosen indices, sharp two color blocks like text come out exact
+    static const float weights[4] = { 1.0f, 0.0f, 2.0f/3.0f, 1.0f/3.0f };
+    float aa = 0, bb = 0, ab = 0, ax[3] = { 0 }, bx[3] = { 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        float a = weights[(indices >> (2*i)) & 3], b = 1.0f - a;
+        aa += a*a;
+        bb += b*b;
+        ab += a*b;
+        for (int c = 0; c < 3; c++)
+        {
+            ax[c] += a*pixels[i*4 + c];
+            bx[c] += b*pixels[i*4 + c];
+        }
+    }
+    float det = aa*bb - ab*ab;
+    if (fabsf(det) < 1e-4f) return false;
+    for (int c = 0; c < 3; c++)
+    {
+        hi[c] = (int)Clamp((ax[c]*bb - bx[c]*ab)/det + 0.5f, 0.0f, 255.0f);
+        lo[c] = (int)Clamp((bx[c]*aa - ax[c]*ab)/det + 0.5f, 0.0f, 255.0f);
+    }
+    return true;
+}
+static void EncodeBc1Block(const unsigned char *pixels, unsigned char *out)
+{
+    // bounding box endpoints on the diagonal the colors actually follow, inset a little so they sit on the colors
+    int lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            if (pixels[i*4 + c] < lo[c]) lo[c] = pixels[i*4 + c];
+            if (pixels[i*4 + c] > hi[c]) hi[c] = pixels[i*4 + c];
+        }
+    }
+    int covG = 0, covB = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int dr = 2*pixels[i*4] - lo[0] - hi[0];
+        covG += dr*(2*pixels[i*4 + 1] - lo[1] - hi[1]);
+        covB += dr*(2*pixels[i*4 + 2] - lo[2] - hi[2]);
+    }
+    if (covG < 0) { int t = lo[1]; lo[1] = hi[1]; hi[1] = t; }
+    if (covB < 0) { int t = lo[2]; lo[2] = hi[2]; hi[2] = t; }
+    for (int c = 0; c < 3; c++)
+    {
+        int inset = (hi[c] - lo[c])/16;
+        lo[c] += inset;
+        hi[c] -= inset;
+    }
+
+    unsigned short c0 = PackRgb565(hi), c1 = PackRgb565(lo);
+    unsigned int indices;
+    int error = PickBc1Indices(pixels, &c0, &c1, &indices);
+    if (error > 0 && c0 != c1 && RefineBc1Endpoints(pixels, indices, hi, lo))
+    {
+        unsigned short r0 = PackRgb565(hi), r1 = PackRgb565(lo);
+        unsigned int refinedIndices;
+        if (PickBc1Indices(pixels, &r0, &r1, &refinedIndices) < error)
+        {
+            c0 = r0;
+            c1 = r1;
+            indices = refinedIndices;
+        }
+    }
+    out[0] = c0 & 0xff; out[1] = c0 >> 8;
+    out[2] = c1 & 0xff; out[3] = c1 >> 8;
+    out[4] = indices & 0xff; out[5] = (indices >> 8) & 0xff; out[6] = (indices >> 16) & 0xff; out[7] = indices >> 24;
+}
+typedef struct{
+    const Image *source;
+    Image *result;
+}Bc1EncodeJob;
+static void EncodeBc1Row(void *ctx, int blockY)
+{
+    Bc1EncodeJob *job = ctx;
+    const unsigned char *src = job->source->data;
+    int width = job->source->width, height = job->source->height;
+    int blocksX = job->result->width/4;
+    unsigned char *out = (unsigned char *)job->result->data + (size_t)blockY*blocksX*8;
+    unsigned char block[64];
+    for (int blockX = 0; blockX < blocksX; blockX++, out += 8)
+    {
+        // the padding past the right and bottom edges repeats the last pixel, it is never sampled
+        for (int y = 0; y < 4; y++)
+        {
+            int sy = blockY*4 + y < height ? blockY*4 + y : height - 1;
+            for (int x = 0; x < 4; x++)
+            {
+                int sx = blockX*4 + x < width ? blockX*4 + x : width - 1;
+                memcpy(block + (y*4 + x)*4, src + ((size_t)sy*width + sx)*4, 4);
+            }
+        }
+        EncodeBc1Block(block, out);
+    }
+}
+Image EncodeBc1(Image source)
+{
+    // source is RGBA8, the result is padded to whole blocks
+    Image result = {
+        .width = (source.width + 3) & ~3,
+        .height = (source.height + 3) & ~3,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_COMPRESSED_DXT1_RGB
+    };
+    result.data = RL_MALLOC(GetPixelDataSize(result.width, result.height, result.format));
+    if (result.data == NULL)
+    {
+        TraceLog(LOG_WARNING, "BGCOMPRESS: Out of memory for a %dx%d BC1 copy", result.width, result.height);
+        return (Image){ 0 };
+    }
+    Bc1EncodeJob job = { .source = &source, .result = &result };
+    ParallelFor(result.height/4, EncodeBc1Row, &job);
+    return result;
+}
+static Texture2D LoadCompressedTexture(Image blocks, int width, int height)
+{
+    Texture2D texture = LoadTextureFromImage(blocks);
+    if (texture.id == 0)
+    {
+        // rlgl refuses formats the driver does not advertise, stay uncompressed for good
+        TraceLog(LOG_WARNING, "BGCOMPRESS: GPU has no BC1 support, backgrounds stay uncompressed");
+        bgCompress.unsupported = true;
+        return texture;
+    }
+    TraceLog(LOG_INFO, "BGCOMPRESS: Background uses %.1f MB of VRAM instead of %.1f MB",
+             GetPixelDataSize(blocks.width, blocks.height, blocks.format)/1048576.0f,
+             GetPixelDataSize(width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)/1048576.0f);
+    return texture;
+}
+bool UseCompressedBackgrounds()
+{
+    return bgCompress.enabled && !bgCompress.unsupported;
+}
+static void EncodeLibraryBackground()
+{
+    // reads the library copy itself, nothing the main thread owns is touched
+    MappedFile file;
+    Image source;
+    BgFileHeader header;
+    bgCompress.result = (Image){ 0 };
+    if (MapBgFile(bgCompress.jobHash, "rgba", &file, &source, &header))
+    {
+        bgCompress.result = EncodeBc1(source);
+        if (bgCompress.result.data != NULL) SaveBgFile(bgCompress.jobHash, "bc1", bgCompress.result, header.width, header.height);
+        bgCompress.width = header.width;
+        bgCompress.height = header.height;
+        UnmapFile(&file);
+    }
+    atomic_store(&bgCompress.state, BG_COMPRESS_DONE);
+}
+static void EncodeLibraryJob(void *data)
+{
+    EncodeLibraryBackground();
+}
+void UpdateBackgroundCompression()
+{
+    int state = atomic_load(&bgCompress.state);
+    if (state == BG_COMPRESS_DONE)
+    {
+        int index = FindLibraryEntry(bgCompress.jobHash);
+        if (index >= 0 && bgCompress.result.data != NULL)
+        {
+            BgLibraryEntry *entry = &library.entries[index];
+            entry->hasBc1 = true;
+            // replaces the uncompressed texture if that one is still on the GPU
+            if (UseCompressedBackgrounds() && entry->texture.id > 0 && entry->texture.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+            {
+                Texture2D texture = LoadCompressedTexture(bgCompress.result, bgCompress.width, bgCompress.height);
+                if (texture.id > 0) SetLibraryTexture(index, texture);
+            }
+        }
+        else if (index < 0 && bgCompress.result.data != NULL)
+        {
+            // the background left the library while it was encoding, its copy would never be cleaned up
+            char path[sizeof(library.directory) + 32];
+            GetBgFilePath(bgCompress.jobHash, "bc1", path, sizeof(path));
+            remove(path);
+        }
+        UnloadImage(bgCompress.result);
+        bgCompress.result = (Image){ 0 };
+        atomic_store(&bgCompress.state, BG_COMPRESS_IDLE);
+        state = BG_COMPRESS_IDLE;
+    }
+    if (state != BG_COMPRESS_IDLE || !UseCompressedBackgrounds()) return;
+
+    // one encode at a time, the background on screen goes first
+    int next = -1;
+    for (int i = 0; i < library.count; i++)
+    {
+        BgLibraryEntry *entry = &library.entries[i];
+        if (entry->hasBc1 || entry->encodeTried || entry->missing) continue;
+        if (next < 0 || i == library.current) next = i;
+    }
+    if (next < 0) return;
+    library.entries[next].encodeTried = true;
+    bgCompress.jobHash = library.entries[next].hash;
+    // the state says when it is done, without workers it already is once SubmitJob returns
+    atomic_store(&bgCompress.state, BG_COMPRESS_BUSY);
+    SubmitJob(EncodeLibraryJob, NULL, NULL);
+}
+void SetBackgroundCompression(bool enabled)
+{
+    if (enabled == bgCompress.enabled) return;
+    bgCompress.enabled = enabled;
+    // everything else leaves the GPU, warming up brings it back in the new format
+    for (int i = 0; i < library.count; i++)
+    {
+        if (i == library.current || library.entries[i].texture.id == 0 || library.entries[i].memoryOnly) continue;
+        UnloadTexture(library.entries[i].texture);
+        library.entries[i].texture = (Texture2D){ 0 };
+    }
+    if (library.current >= 0) LoadLibraryTexture(library.current);
+}
+void StopBackgroundCompression()
+{
+    // after ShutdownJobSystem the encode has always finished, anyone stopping earlier waits for it
+#if !defined(PLATFORM_WEB)
+    while (atomic_load(&bgCompress.state) == BG_COMPRESS_BUSY) sched_yield();
+#endif
+    UnloadImage(bgCompress.result);
+    bgCompress.result = (Image){ 0 };
+    atomic_store(&bgCompress.state, BG_COMPRESS_IDLE);
+}
+#pragma endregion
+#pragma region Background Library
+void GetBgFilePath(unsigned long long hash, const char *extension, char *path, int size)
+{
+    snprintf(path, size, "%s/%016llx.%s", library.directory, hash, extension);
+}
+bool SaveBgFile(unsigned long long hash, const char *extension, Image image, int width, int height)
+{
+    // written next to the final name and swapped in, a reader never sees half a file
+    char path[sizeof(library.directory) + 32];
+    char tmpPath[sizeof(path) + 8];
+    GetBgFilePath(hash, extension, path, sizeof(path));
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    MakeDirectory(library.directory);
+    BgFileHeader header = { .magic = BG_FILE_MAGIC, .headerSize = sizeof(BgFileHeader), .width = width, .height = height,
+                            .dataWidth = image.width, .dataHeight = image.height, .format = image.format,
+                            .size = (unsigned int)GetPixelDataSize(image.width, image.height, image.format) };
+    FILE *file = fopen(tmpPath, "wb");
+    bool ok = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(image.data, 1, header.size, file) == header.size;
+    if (file != NULL) ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmpPath, path) != 0)
+    {
+        TraceLog(LOG_WARNING, "BGLIBRARY: [%s] Failed to write", path);
+        remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+static bool CheckBgFileHeader(const BgFileHeader *header, size_t available)
+{
+    if (header->magic != BG_FILE_MAGIC || header->headerSize != sizeof(BgFileHeader) ||
+        header->width <= 0 || header->height <= 0 || header->width > 16384 || header->height > 16384) return false;
+    int dataWidth = header->width, dataHeight = header->height;
+    if (header->format == PIXELFORMAT_COMPRESSED_DXT1_RGB)
+    {
+        dataWidth = (dataWidth + 3) & ~3;
+        dataHeight = (dataHeight + 3) & ~3;
+    }
+    else if (header->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return false;
+    return header->dataWidth == dataWidth && header->dataHeight == dataHeight &&
+           GetPixelDataSize(dataWidth, dataHeight, header->format) == (int)header->size && available >= header->size;
+}
+bool ReadBgFileHeader(unsigned long long hash, const char *extension, BgFileHeader *header)
+{
+    char path[sizeof(library.directory) + 32];
+    GetBgFilePath(hash, extension, path, sizeof(path));
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+    bool ok = fread(header, sizeof(BgFileHeader), 1, file) == 1 && fseek(file, 0, SEEK_END) == 0;
+    long size = ok ? ftell(file) : -1;
+    fclose(file);
+    return ok && size >= (long)sizeof(BgFileHeader) && CheckBgFileHeader(header, size - sizeof(BgFileHeader));
+}
+bool MapBgFile(unsigned long long hash, const char *extension, MappedFile *file, Image *image, BgFileHeader *header)
+{
+    char path[sizeof(library.directory) + 32];
+    GetBgFilePath(hash, extension, path, sizeof(path));
+    if (!FileExists(path)) return false;
+    *file = MapFile(path);
+    if (file->data != NULL && file->size >= sizeof(BgFileHeader))
+    {
+        memcpy(header, file->data, sizeof(BgFileHeader));
+        if (CheckBgFileHeader(header, file->size - sizeof(BgFileHeader)))
+        {
+            *image = (Image){ file->data + sizeof(BgFileHeader), header->dataWidth, header->dataHeight, 1, header->format };
+            return true;
+        }
+    }
+    TraceLog(LOG_WARNING, "BGLIBRARY: [%s] Ignoring corrupt file", path);
+    UnmapFile(file);
+    return false;
+}
+int FindLibraryEntry(unsigned long long hash)
+{
+    for (int i = 0; i < library.count; i++)
+        if (library.entries[i].hash == hash) return i;
+    return -1;
+}
+static size_t GetTextureBytes(Texture2D texture)
+{
+    return texture.id > 0 ? (size_t)GetPixelDataSize(texture.width, texture.height, texture.format) : 0;
+}
+size_t GetLibraryVram()
+{
+    size_t used = 0;
+    for (int i = 0; i < library.count; i++) used += GetTextureBytes(library.entries[i].texture);
+    return used;
+}
+static size_t EstimateLibraryBytes(const BgLibraryEntry *entry)
+{
+    if (UseCompressedBackgrounds() && entry->hasBc1) return (size_t)((entry->width + 3) & ~3)*((entry->height + 3) & ~3)/2;
+    return (size_t)entry->width*entry->height*4;
+}
+static void ShowLibraryEntry()
+{
+    // bgImage only borrows the texture, the library owns it
+    BgLibraryEntry *entry = &library.entries[library.current];
+    bgImage.bg_texture = entry->texture;
+    bgImage.bg_source_rect.width = entry->width;
+    bgImage.bg_source_rect.height = entry->height;
+    bgImage.image_loaded = entry->texture.id > 0;
+}
+void SetLibraryTexture(int index, Texture2D texture)
+{
+    BgLibraryEntry *entry = &library.entries[index];
+    if (entry->texture.id > 0) UnloadTexture(entry->texture);
+    entry->texture = texture;
+
+    // over budget the backgrounds shown longest ago leave the GPU, the one on screen never does
+    size_t used = GetLibraryVram();
+    while (used > library.vramBudget)
+    {
+        int victim = -1;
+        for (int i = 0; i < library.count; i++)
+        {
+            if (i == index || i == library.current || library.entries[i].texture.id == 0 || library.entries[i].memoryOnly) continue;
+            if (victim < 0 || library.entries[i].lastUsed < library.entries[victim].lastUsed) victim = i;
+        }
+        if (victim < 0) break;
+        used -= GetTextureBytes(library.entries[victim].texture);
+        UnloadTexture(library.entries[victim].texture);
+        library.entries[victim].texture = (Texture2D){ 0 };
+    }
+    if (index == library.current) ShowLibraryEntry();
+}
+bool LoadLibraryTexture(int index)
+{
+    BgLibraryEntry *entry = &library.entries[index];
+    MappedFile file;
+    Image image;
+    BgFileHeader header;
+    Texture2D texture = { 0 };
+    // a BC1 copy from an earlier run skips the full size upload and the encode altogether
+    if (UseCompressedBackgrounds() && entry->hasBc1 && MapBgFile(entry->hash, "bc1", &file, &image, &header))
+    {
+        texture = LoadCompressedTexture(image, header.width, header.height);
+        UnmapFile(&file);
+    }
+    if (texture.id == 0 && MapBgFile(entry->hash, "rgba", &file, &image, &header))
+    {
+        // straight from the mapping, no copy on the way to the GPU
+        texture = LoadTextureFromImage(image);
+        UnmapFile(&file);
+    }
+    if (texture.id == 0)
+    {
+        entry->missing = true;
+        return false;
+    }
+    entry->width = header.width;
+    entry->height = header.height;
+    SetLibraryTexture(index, texture);
+    return true;
+}
+void SelectLibraryEntry(int index)
+{
+    if (index < 0 || index >= library.count) return;
+    library.current = index;
+    library.entries[index].lastUsed = ++library.useClock;
+    if (library.entries[index].texture.id == 0)
+    {
+        // a miss costs a disk read and a full upload, the budget decides how often that happens
+        double start = ClockSeconds();
+        if (LoadLibraryTexture(index) && startup.firstFramePresented)
+            TraceLog(LOG_INFO, "BGLIBRARY: Background %d was not resident, loaded in %.1f ms", index + 1, (ClockSeconds() - start)*1000.0);
+        else if (library.entries[index].missing) TraceLog(LOG_WARNING, "BGLIBRARY: Background %d is missing from %s", index + 1, BG_LIBRARY_DIR);
+    }
+    ShowLibraryEntry();
+}
+void AddLibraryBackground(Image image)
+{
+    // takes ownership of an RGBA8 image, an identical background already in the library is just selected
+    unsigned long long hash = HashPixels(image);
+    int index = FindLibraryEntry(hash);
+    // one whose file went away comes back from this copy instead of failing to load
+    bool restore = false;
+    if (index >= 0 && library.entries[index].texture.id == 0 && !library.entries[index].memoryOnly)
+    {
+        char path[sizeof(library.directory) + 32];
+        GetBgFilePath(hash, "rgba", path, sizeof(path));
+        restore = library.entries[index].missing || !FileExists(path);
+    }
+    if (index < 0 || restore)
+    {
+        if (restore) TraceLog(LOG_INFO, "BGLIBRARY: Background %d was missing, saving it again", index + 1);
+        else if (library.count < BG_LIBRARY_SLOTS) index = library.count++;
+        else
+        {
+            // full, the background shown longest ago makes room and its files go with it, unless its BC1 copy is still being written
+            bool encoding = atomic_load(&bgCompress.state) == BG_COMPRESS_BUSY;
+            index = -1;
+            for (int i = 0; i < library.count; i++)
+            {
+                if (encoding && library.entries[i].hash == bgCompress.jobHash) continue;
+                if (index < 0 || library.entries[i].lastUsed < library.entries[index].lastUsed) index = i;
+            }
+            char path[sizeof(library.directory) + 32];
+            GetBgFilePath(library.entries[index].hash, "rgba", path, sizeof(path));
+            remove(path);
+            GetBgFilePath(library.entries[index].hash, "bc1", path, sizeof(path));
+            remove(path);
+            if (library.entries[index].texture.id > 0) UnloadTexture(library.entries[index].texture);
+        }
+        library.entries[index] = (BgLibraryEntry){ .hash = hash, .width = image.width, .height = image.height };
+        if (!SaveBgFile(hash, "rgba", image, image.width, image.height))
+        {
+            // a read only or full app directory still gets the background, it just stays on the GPU and out of the profile
+            TraceLog(LOG_WARNING, "BGLIBRARY: Background %d is kept for this run only", index + 1);
+            library.entries[index].memoryOnly = true;
+            library.entries[index].encodeTried = true;
+        }
+        SetLibraryTexture(index, LoadTextureFromImage(image));
+    }
+    UnloadImage(image);
+    SelectLibraryEntry(index);
+}
+void LoadBackgroundLibrary()
+{
+    // resolved once, the compression worker builds paths too and raylib's path helpers share static buffers
+    snprintf(library.directory, sizeof(library.directory), "%s%s", GetApplicationDirectory(), BG_LIBRARY_DIR);
+    for (int i = 0; i < library.count; i++)
+    {
+        // sizes up front so warming up can stay inside the budget without touching any pixels
+        BgLibraryEntry *entry = &library.entries[i];
+        BgFileHeader header;
+        if (ReadBgFileHeader(entry->hash, "rgba", &header))
+        {
+            entry->width = header.width;
+            entry->height = header.height;
+        }
+        else entry->missing = true;
+        entry->hasBc1 = ReadBgFileHeader(entry->hash, "bc1", &header);
+    }
+    // only the one on screen loads before the first frame
+    if (library.count > 0) SelectLibraryEntry(library.current);
+}
+void UpdateBackgroundLibrary()
+{
+    // tab cycles, number keys jump straight to a background
+    if (library.count > 1 && IsKeyPressed(KEY_TAB)) SelectLibraryEntry((library.current + 1) % library.count);
+    for (int i = 0; i < library.count; i++)
+        if (IsKeyPressed(KEY_ONE + i)) SelectLibraryEntry(i);
+
+    // one background at a time is read on the job system while the budget has room, switching to it later takes a single frame
+    if (!startup.firstFramePresented || library.warming) return;
+    size_t used = GetLibraryVram();
+    int next = -1;
+    for (int i = 0; i < library.count; i++)
+    {
+        BgLibraryEntry *entry = &library.entries[i];
+        if (entry->texture.id > 0 || entry->missing || used + EstimateLibraryBytes(entry) > library.vramBudget) continue;
+        if (next < 0 || entry->lastUsed > library.entries[next].lastUsed) next = i;
+    }
+    if (next < 0) return;
+    LibraryWarmJob *job = calloc(1, sizeof(LibraryWarmJob));
+    if (job == NULL) return;
+    job->hash = library.entries[next].hash;
+    job->compressed = UseCompressedBackgrounds() && library.entries[next].hasBc1;
+    library.warming = true;
+    SubmitJob(ReadLibraryJob, UploadLibraryJob, job);
+}
+void ReadLibraryJob(void *data)
+{
+    // copying out of the mapping is the disk read, it happens here instead of inside the upload
+    LibraryWarmJob *job = data;
+    MappedFile file;
+    Image image;
+    if ((job->compressed && MapBgFile(job->hash, "bc1", &file, &image, &job->header)) ||
+        MapBgFile(job->hash, "rgba", &file, &image, &job->header))
+    {
+        job->image = image;
+        job->image.data = malloc(job->header.size);
+        if (job->image.data != NULL) memcpy(job->image.data, image.data, job->header.size);
+        job->ok = job->image.data != NULL;
+        UnmapFile(&file);
+    }
+}
+void UploadLibraryJob(void *data)
+{
+    LibraryWarmJob *job = data;
+    library.warming = false;
+    // the slot may have been replaced or loaded by a switch while the read was out
+    int index = FindLibraryEntry(job->hash);
+    if (index >= 0 && library.entries[index].texture.id == 0)
+    {
+        BgLibraryEntry *entry = &library.entries[index];
+        bool bc1 = job->header.format == PIXELFORMAT_COMPRESSED_DXT1_RGB;
+        Texture2D texture = { 0 };
+        // compression toggled meanwhile, the next warm up reads the other copy
+        if (job->ok && (!bc1 || UseCompressedBackgrounds()))
+            texture = bc1 ? LoadCompressedTexture(job->image, job->header.width, job->header.height) : LoadTextureFromImage(job->image);
+        if (texture.id > 0)
+        {
+            entry->width = job->header.width;
+            entry->height = job->header.height;
+            SetLibraryTexture(index, texture);
+        }
+        else if (!job->ok) entry->missing = true;
+    }
+    UnloadImage(job->image);
+    free(job);
+}
+void UnloadBackgroundLibrary()
+{
+    for (int i = 0; i < library.count; i++)
+        if (library.entries[i].texture.id > 0) UnloadTexture(library.entries[i].texture);
+    library.count = 0;
+    library.current = -1;
+    bgImage.image_loaded = false;
+}
+#pragma endregion
+#pragma region Render Stats
+#if !defined(PLATFORM_WEB)
+// raylib's GL calls all go through glad's pointers, swapping them for counting wrappers sees every one
+static void (*glDrawArraysReal)(unsigned int mode, int first, int count);
+static void (*glDrawElementsReal)(unsigned int mode, int count, unsigned int type, const void *indices);
+static void (*glDrawArraysInstancedReal)(unsigned int mode, int first, int count, int instances);
+static void (*glDrawElementsInstancedReal)(unsigned int mode, int count, unsigned int type, const void *indices, int instances);
+static void (*glBindTextureReal)(unsigned int target, unsigned int texture);
+static void (*glBindBufferReal)(unsigned int target, unsigned int buffer);
+static void (*glBufferDataReal)(unsigned int target, ptrdiff_t size, const void *data, unsigned int usage);
+static void (*glBufferSubDataReal)(unsigned int target, ptrdiff_t offset, ptrdiff_t size, const void *data);
+static void (*glTexImage2DReal)(unsigned int target, int level, int internalFormat, int width, int height, int border, unsigned int format, unsigned int type, const void *pixels);
+static void (*glTexSubImage2DReal)(unsigned int target, int level, int x, int y, int width, int height, unsigned int format, unsigned int type, const void *pixels);
+static void (*glCompressedTexImage2DReal)(unsigned int target, int level, unsigned int internalFormat, int width, int height, int border, int imageSize, const void *data);
+
+static unsigned int GetGlPixelBytes(unsigned int format, unsigned int type)
+{
+    // packed 16 bit types cover the whole pixel
+    if (type == GL_UNSIGNED_SHORT_5_6_5 || type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_5_5_1) return 2;
+    unsigned int components = (format == GL_RGBA || format == GL_BGRA) ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1;
+    return components*(type == GL_FLOAT ? 4 : type == GL_HALF_FLOAT ? 2 : 1);
+}
+static void CountDrawArrays(unsigned int mode, int first, int count)
+{
+    renderStats.current.drawCalls++;
+    renderStats.current.vertices += count;
+    glDrawArraysReal(mode, first, count);
+}
+static void CountDrawElements(unsigned int mode, int count, unsigned int type, const void *indices)
+{
+    renderStats.current.drawCalls++;
+    renderStats.current.vertices += count;
+    glDrawElementsReal(mode, count, type, indices);
+}
+static void CountDrawArraysInstanced(unsigned int mode, int first, int count, int instances)
+{
+    renderStats.current.drawCalls++;
+    renderStats.current.vertices += (unsigned int)count*instances;
+    glDrawArraysInstancedReal(mode, first, count, instances);
+}
+static void CountDrawElementsInstanced(unsigned int mode, int count, unsigned int type, const void *indices, int instances)
+{
+    renderStats.current.drawCalls++;
+    renderStats.current.vertices += (unsigned int)count*instances;
+    glDrawElementsInstancedReal(mode, count, type, indices, instances);
+}
+static void CountBindTexture(unsigned int target, unsigned int texture)
+{
+    renderStats.current.textureBinds++;
+    glBindTextureReal(target, texture);
+}
+static void CountBindBuffer(unsigned int target, unsigned int buffer)
+{
+    if (target == GL_ARRAY_BUFFER) renderStats.arrayBuffer = buffer;
+    glBindBufferReal(target, buffer);
+}
+static void CountBufferData(unsigned int target, ptrdiff_t size, const void *data, unsigned int usage)
+{
+    if (data != NULL) renderStats.current.uploadBytes += size;
+    glBufferDataReal(target, size, data, usage);
+}
+static void CountBufferSubData(unsigned int target, ptrdiff_t offset, ptrdiff_t size, const void *data)
+{
+    renderStats.current.uploadBytes += size;
+    // rlgl refreshes the batch positions first on every flush, a flush close to capacity is one forced by overflow
+    if (target == GL_ARRAY_BUFFER && offset == 0 && renderStats.arrayBuffer == renderStats.batch.vertexBuffer[0].vboId[0])
+    {
+        renderStats.current.flushes++;
+        int vertexCount = (int)(size/(3*sizeof(float)));
+        if (vertexCount >= renderStats.batch.vertexBuffer[0].elementCount*4 - RENDER_OVERFLOW_SLACK) renderStats.current.overflows++;
+    }
+    glBufferSubDataReal(target, offset, size, data);
+}
+static void CountTexImage2D(unsigned int target, int level, int internalFormat, int width, int height, int border, unsigned int format, unsigned int type, const void *pixels)
+{
+    if (pixels != NULL) renderStats.current.uploadBytes += (unsigned long long)width*height*GetGlPixelBytes(format, type);
+    glTexImage2DReal(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+static void CountTexSubImage2D(unsigned int target, int level, int x, int y, int width, int height, unsigned int format, unsigned int type, const void *pixels)
+{
+    renderStats.current.uploadBytes += (unsigned long long)width*height*GetGlPixelBytes(format, type);
+    glTexSubImage2DReal(target, level, x, y, width, height, format, type, pixels);
+}
+static void CountCompressedTexImage2D(unsigned int target, int level, unsigned int internalFormat, int width, int height, int border, int imageSize, const void *data)
+{
+    if (data != NULL) renderStats.current.uploadBytes += imageSize;
+    glCompressedTexImage2DReal(target, level, internalFormat, width, height, border, imageSize, data);
+}
+#endif
+void InstallRenderStats()
+{
+#if !defined(PLATFORM_WEB)
+    // our own batch in place of rlgl's default one, only so its vertex buffer id is known
+    renderStats.batch = rlLoadRenderBatch(1, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
+    rlSetRenderBatchActive(&renderStats.batch);
+
+    glDrawArraysReal = glad_glDrawArrays;
+    glDrawElementsReal = glad_glDrawElements;
+    glDrawArraysInstancedReal = glad_glDrawArraysInstanced;
+    glDrawElementsInstancedReal = glad_glDrawElementsInstanced;
+    glBindTextureReal = glad_glBindTexture;
+    glBindBufferReal = glad_glBindBuffer;
+    glBufferDataReal = glad_glBufferData;
+    glBufferSubDataReal = glad_glBufferSubData;
+    glTexImage2DReal = glad_glTexImage2D;
+    glTexSubImage2DReal = glad_glTexSubImage2D;
+    glCompressedTexImage2DReal = glad_glCompressedTexImage2D;
+    glad_glDrawArrays = CountDrawArrays;
+    glad_glDrawElements = CountDrawElements;
+    if (glDrawArraysInstancedReal != NULL) glad_glDrawArraysInstanced = CountDrawArraysInstanced;
+    if (glDrawElementsInstancedReal != NULL) glad_glDrawElementsInstanced = CountDrawElementsInstanced;
+    glad_glBindTexture = CountBindTexture;
+    glad_glBindBuffer = CountBindBuffer;
+    glad_glBufferData = CountBufferData;
+    glad_glBufferSubData = CountBufferSubData;
+    glad_glTexImage2D = CountTexImage2D;
+    glad_glTexSubImage2D = CountTexSubImage2D;
+    if (glCompressedTexImage2DReal != NULL) glad_glCompressedTexImage2D = CountCompressedTexImage2D;
+    renderStats.installed = true;
+#endif
+}
+void UninstallRenderStats()
+{
+#if !defined(PLATFORM_WEB)
+    if (!renderStats.installed) return;
+    rlSetRenderBatchActive(NULL);
+    rlUnloadRenderBatch(renderStats.batch);
+    glad_glDrawArrays = glDrawArraysReal;
+    glad_glDrawElements = glDrawElementsReal;
+    glad_glDrawArraysInstanced = glDrawArraysInstancedReal;
+    glad_glDrawElementsInstanced = glDrawElementsInstancedReal;
+    glad_glBindTexture = glBindTextureReal;
+    glad_glBindBuffer = glBindBufferReal;
+    glad_glBufferData = glBufferDataReal;
+    glad_glBufferSubData = glBufferSubDataReal;
+    glad_glTexImage2D = glTexImage2DReal;
+    glad_glTexSubImage2D = glTexSubImage2DReal;
+    glad_glCompressedTexImage2D = glCompressedTexImage2DReal;
+    renderStats.installed = false;
+#endif
+    if (renderStats.log != NULL) fclose(renderStats.log);
+    renderStats.log = NULL;
+}
+void OpenRenderStatsLog(const char *fileName)
+{
+    renderStats.log = fopen(fileName, "w");
+    if (renderStats.log == NULL)
+    {
+        TraceLog(LOG_WARNING, "STATS: [%s] Failed to open render log", fileName);
+        return;
+    }
+    fprintf(renderStats.log, "frame,frame_ms,draw_calls,vertices,texture_binds,flushes,overflows,upload_bytes,targets_tested,targets_drawn\n");
+}
+void EndRenderStatsFrame()
+{
+    // called right after EndDrawing, the final flush and the swap belong to the frame that just ended
+    renderStats.last = renderStats.current;
+    renderStats.current = (RenderCounters){ 0 };
+    renderStats.frame++;
+    if (renderStats.log != NULL)
+    {
+        RenderCounters *c = &renderStats.last;
+        fprintf(renderStats.log, "%u,%.3f,%u,%u,%u,%u,%u,%llu,%u,%u\n", renderStats.frame, GetFrameTime()*1000.0f,
+                c->drawCalls, c->vertices, c->textureBinds, c->flushes, c->overflows, c->uploadBytes, c->targetsTested, c->targetsDrawn);
+    }
+}
+void DrawRenderStats()
+{
+    if (!renderStats.showOverlay) return;
+    RenderCounters *c = &renderStats.last;
+    if (renderStats.installed)
+        DrawUiText(TextFormat("draws %u  verts %u  binds %u  flushes %u (%u overflow)  upload %.1f KB",
+                 c->drawCalls, c->vertices, c->textureBinds, c->flushes, c->overflows, c->uploadBytes/1024.0f), 4, screenHeight - 28, 10, GRAY);
+    else DrawUiText("render stats need the desktop build", 4, screenHeight - 28, 10, GRAY);
+    unsigned int *lod = c->targetsPerLod;
+    DrawUiText(TextFormat("targets drawn %u of %u  lod %u/%u/%u/%u/%u  cull %s  depth sort %s", c->targetsDrawn, c->targetsTested,
+             lod[0], lod[1], lod[2], lod[3], lod[4], culling.enabled ? "on" : "off", culling.depthSort ? "on" : "off"), 4, screenHeight - 56, 10, GRAY);
+}
+#pragma endregion
+#pragma region GPU Timers
+void InitGpuTimers()
+{
+#if !defined(PLATFORM_WEB)
+    // timestamps instead of elapsed time queries, the 3D pass sits inside the HUD pass and elapsed queries can't nest
+    int bits = 0;
+    if (glad_glQueryCounter != NULL && glad_glGetQueryiv != NULL) glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    if (bits == 0)
+    {
+        TraceLog(LOG_WARNING, "GPUTIMER: Driver has no timestamp queries, GPU pass timing disabled");
+        return;
+    }
+    glGenQueries(GPU_TIMER_FRAMES*GPU_MARK_COUNT, &gpuTimers.queries[0][0]);
+    gpuTimers.supported = true;
+#endif
+}
+void UnloadGpuTimers()
+{
+#if !defined(PLATFORM_WEB)
+    if (gpuTimers.supported) glDeleteQueries(GPU_TIMER_FRAMES*GPU_MARK_COUNT, &gpuTimers.queries[0][0]);
+    gpuTimers.supported = false;
+#endif
+    if (gpuTimers.log != NULL) fclose(gpuTimers.log);
+    gpuTimers.log = NULL;
+}
+void OpenGpuTimerLog(const char *fileName)
+{
+    gpuTimers.log = fopen(fileName, "w");
+    if (gpuTimers.log == NULL)
+    {
+        TraceLog(LOG_WARNING, "GPUTIMER: [%s] Failed to open log", fileName);
+        return;
+    }
+    fprintf(gpuTimers.log, "frame,background_ms,scene_ms,hud_ms\n");
+    gpuTimers.enabled = true;
+}
+#if !defined(PLATFORM_WEB)
+static void ReadGpuTimerSlot(int slot)
+{
+    unsigned long long t[GPU_MARK_COUNT] = { 0 };
+    for (int mark = 0; mark < GPU_MARK_COUNT; mark++)
+        if (gpuTimers.issued[slot] & (1u << mark)) glGetQueryObjectui64v(gpuTimers.queries[slot][mark], GL_QUERY_RESULT, &t[mark]);
+
+    // the HUD pass is everything after the background that isn't the 3D layer
+    float background = (t[GPU_MARK_BACKGROUND_END] - t[GPU_MARK_FRAME_START])*1e-6f;
+    float scene = 0.0f;
+    float hud = (t[GPU_MARK_FRAME_END] - t[GPU_MARK_BACKGROUND_END])*1e-6f;
+    bool hasScene = (gpuTimers.issued[slot] & (1u << GPU_MARK_SCENE_END)) != 0;
+    if (hasScene)
+    {
+        scene = (t[GPU_MARK_SCENE_END] - t[GPU_MARK_SCENE_START])*1e-6f;
+        hud -= scene;
+        gpuTimers.lastSceneMs = scene;
+        gpuTimers.lastOtherMs = background + hud;
+        gpuTimers.sceneSampled = true;
+    }
+    gpuTimers.backgroundMs = Lerp(gpuTimers.backgroundMs, background, GPU_TIMER_SMOOTHING);
+    gpuTimers.sceneMs = Lerp(gpuTimers.sceneMs, scene, GPU_TIMER_SMOOTHING);
+    gpuTimers.hudMs = Lerp(gpuTimers.hudMs, hud, GPU_TIMER_SMOOTHING);
+    if (gpuTimers.log != NULL) fprintf(gpuTimers.log, "%u,%.4f,%.4f,%.4f\n", gpuTimers.frameOfSlot[slot], background, scene, hud);
+    unsigned int frame = gpuTimers.frameOfSlot[slot];
+    if (bench.running && frame >= bench.gpuFirstFrame && frame < bench.gpuEndFrame) bench.gpuMs[bench.gpuCount++] = background + scene + hud;
+}
+#endif
+void BeginGpuFrame()
+{
+#if !defined(PLATFORM_WEB)
+    if (!gpuTimers.supported || !gpuTimers.enabled) return;
+    // results come back a few frames late, only ever read the ones the driver says are done
+    for (int i = 1; i <= GPU_TIMER_FRAMES; i++)
+    {
+        int slot = (gpuTimers.slot + i) % GPU_TIMER_FRAMES;
+        if (!gpuTimers.pending[slot]) continue;
+        int available = 0;
+        glGetQueryObjectiv(gpuTimers.queries[slot][GPU_MARK_FRAME_END], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        ReadGpuTimerSlot(slot);
+        gpuTimers.pending[slot] = false;
+    }
+    gpuTimers.slot = (gpuTimers.slot + 1) % GPU_TIMER_FRAMES;
+    if (gpuTimers.pending[gpuTimers.slot])
+    {
+        // still not back after a full ring of frames, drop it rather than wait
+        gpuTimers.dropped++;
+        gpuTimers.pending[gpuTimers.slot] = false;
+    }
+    gpuTimers.issued[gpuTimers.slot] = 0;
+    gpuTimers.frameOfSlot[gpuTimers.slot] = gpuTimers.frame;
+#endif
+}
+void MarkGpuTimer(GpuTimerMark mark)
+{
+#if !defined(PLATFORM_WEB)
+    if (!gpuTimers.supported || !gpuTimers.enabled) return;
+    // whatever is still batched belongs to the pass that just ended
+    rlDrawRenderBatchActive();
+    glQueryCounter(gpuTimers.queries[gpuTimers.slot][mark], GL_TIMESTAMP);
+    gpuTimers.issued[gpuTimers.slot] |= 1u << mark;
+#endif
+}
+void EndGpuFrame()
+{
+#if !defined(PLATFORM_WEB)
+    if (!gpuTimers.supported || !gpuTimers.enabled) return;
+    MarkGpuTimer(GPU_MARK_FRAME_END);
+    gpuTimers.pending[gpuTimers.slot] = true;
+    gpuTimers.frame++;
+#endif
+}
+void SetGpuTimersEnabled(bool enabled)
+{
+    // slots from before a pause would mix old frames into the averages
+    for (int i = 0; i < GPU_TIMER_FRAMES; i++) gpuTimers.pending[i] = false;
+    gpuTimers.enabled = enabled;
+}
+void DrawGpuTimers()
+{
+    if (!gpuTimers.enabled) return;
+    if (gpuTimers.supported)
+        DrawUiText(TextFormat("gpu  background %.2f ms  3d %.2f ms  hud %.2f ms", gpuTimers.backgroundMs, gpuTimers.sceneMs, gpuTimers.hudMs), 4, screenHeight - 42, 10, GRAY);
+    else DrawUiText("gpu timing not available", 4, screenHeight - 42, 10, GRAY);
+}
+#pragma endregion
+#pragma region Target Culling
+ViewFrustum GetViewFrustum(Camera camera, float aspect)
+{
+    // the same perspective BeginMode3D sets up, with the side planes through the camera position
+    ViewFrustum frustum = { 0 };
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+    float tanV = tanf(camera.fovy*0.5f*DEG2RAD);
+    float tanH = tanV*aspect;
+    Vector3 normals[6] = {
+        Vector3Add(right, Vector3Scale(forward, tanH)),
+        Vector3Add(Vector3Negate(right), Vector3Scale(forward, tanH)),
+        Vector3Add(up, Vector3Scale(forward, tanV)),
+        Vector3Add(Vector3Negate(up), Vector3Scale(forward, tanV)),
+        forward,
+        Vector3Negate(forward),
+    };
+    for (int i = 0; i < 6; i++)
+    {
+        Vector3 n = Vector3Normalize(normals[i]);
+        frustum.nx[i] = n.x;
+        frustum.ny[i] = n.y;
+        frustum.nz[i] = n.z;
+        frustum.d[i] = -Vector3DotProduct(n, camera.position);
+    }
+    frustum.d[4] -= RL_CULL_DISTANCE_NEAR;
+    frustum.d[5] += RL_CULL_DISTANCE_FAR;
+    frustum.position = camera.position;
+    frustum.forward = forward;
+    return frustum;
+}
+int CullSpheres(const ViewFrustum *frustum, const float *x, const float *y, const float *z, int count, float radius, CullEntry *visible)
+{
+    // keeps every sphere that touches the frustum, with its depth for sorting
+    const ViewFrustum *f = frustum;
+    int drawn = 0;
+    int i = 0;
+#if defined(__SSE2__)
+    // four spheres against one plane per step
+    __m128 negRadius = _mm_set1_ps(-radius);
+    __m128 fx = _mm_set1_ps(f->forward.x), fy = _mm_set1_ps(f->forward.y), fz = _mm_set1_ps(f->forward.z);
+    __m128 px = _mm_set1_ps(f->position.x), py = _mm_set1_ps(f->position.y), pz = _mm_set1_ps(f->position.z);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 xv = _mm_loadu_ps(x + i), yv = _mm_loadu_ps(y + i), zv = _mm_loadu_ps(z + i);
+        __m128 inside = _mm_cmpeq_ps(xv, xv);
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f->nx[p]), xv), _mm_mul_ps(_mm_set1_ps(f->ny[p]), yv)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(f->nz[p]), zv), _mm_set1_ps(f->d[p])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+        int mask = _mm_movemask_ps(inside);
+        if (mask == 0) continue;
+        float depth[4];
+        _mm_storeu_ps(depth, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(xv, px), fx), _mm_mul_ps(_mm_sub_ps(yv, py), fy)),
+                                        _mm_mul_ps(_mm_sub_ps(zv, pz), fz)));
+        for (int k = 0; k < 4; k++)
+            if (mask & (1 << k)) visible[drawn++] = (CullEntry){ .depth = depth[k], .index = i + k };
+    }
+#endif
+    for (; i < count; i++)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; p++) inside = f->nx[p]*x[i] + f->ny[p]*y[i] + f->nz[p]*z[i] + f->d[p] >= -radius;
+        if (!inside) continue;
+        float depth = (x[i] - f->position.x)*f->forward.x + (y[i] - f->position.y)*f->forward.y + (z[i] - f->position.z)*f->forward.z;
+        visible[drawn++] = (CullEntry){ .depth = depth, .index = i };
+    }
+    return drawn;
+}
+static int CompareCullDepth(const void *a, const void *b)
+{
+    float x = ((const CullEntry *)a)->depth, y = ((const CullEntry *)b)->depth;
+    return (x > y) - (x < y);
+}
+static const int sphereLodRings[SPHERE_LOD_LEVELS] = { 2, 4, 6, 10, 16 };
+static const int sphereLodSlices[SPHERE_LOD_LEVELS] = { 6, 8, 12, 14, 16 };
+static const float sphereLodPixels[SPHERE_LOD_LEVELS] = { 0.0f, 4.0f, 10.0f, 24.0f, 60.0f }; // projected radius each level starts at
+void InitSphereLods()
+{
+    // same layout and winding as raylib's DrawSphereEx, built once instead of a sin and cos per vertex per target
+    for (int l = 0; l < SPHERE_LOD_LEVELS; l++)
+    {
+        SphereLod *lod = &culling.lods[l];
+        int rings = sphereLodRings[l], slices = sphereLodSlices[l];
+        lod->vertices = malloc((rings + 2)*slices*6*sizeof(Vector3));
+        lod->vertexCount = 0;
+        #define SPHERE_POINT(i, j) (Vector3){ cosf(DEG2RAD*(270 + (180.0f/(rings + 1))*(i)))*sinf(DEG2RAD*(360.0f*(j)/slices)), \
+                                              sinf(DEG2RAD*(270 + (180.0f/(rings + 1))*(i))), \
+                                              cosf(DEG2RAD*(270 + (180.0f/(rings + 1))*(i)))*cosf(DEG2RAD*(360.0f*(j)/slices)) }
+        for (int i = 0; i < rings + 2; i++)
+        {
+            for (int j = 0; j < slices; j++)
+            {
+                lod->vertices[lod->vertexCount++] = SPHERE_POINT(i, j);
+                lod->vertices[lod->vertexCount++] = SPHERE_POINT(i + 1, j + 1);
+                lod->vertices[lod->vertexCount++] = SPHERE_POINT(i + 1, j);
+                lod->vertices[lod->vertexCount++] = SPHERE_POINT(i, j);
+                lod->vertices[lod->vertexCount++] = SPHERE_POINT(i, j + 1);
+                lod->vertices[lod->vertexCount++] = SPHERE_POINT(i + 1, j + 1);
+            }
+        }
+        #undef SPHERE_POINT
+    }
+}
+void UnloadSphereLods()
+{
+    for (int l = 0; l < SPHERE_LOD_LEVELS; l++)
+    {
+        free(culling.lods[l].vertices);
+        culling.lods[l] = (SphereLod){ 0 };
+    }
+    free(culling.entries);
+    culling.entries = NULL;
+    culling.capacity = 0;
+}
+int SelectSphereLod(float pixelRadius, int previous)
+{
+    // thresholds are crossed by a margin in either direction, a target sitting on one doesn't flicker between levels
+    int level = previous < SPHERE_LOD_LEVELS ? previous : SPHERE_LOD_LEVELS - 1;
+    while (level + 1 < SPHERE_LOD_LEVELS && pixelRadius > sphereLodPixels[level + 1]*(1.0f + SPHERE_LOD_HYSTERESIS)) level++;
+    while (level > 0 && pixelRadius < sphereLodPixels[level]*(1.0f - SPHERE_LOD_HYSTERESIS)) level--;
+    return level;
+}
+static void DrawSphereLod(const SphereLod *lod, Vector3 center, float radius, Color color)
+{
+    rlCheckRenderBatchLimit(lod->vertexCount);
+    rlBegin(RL_TRIANGLES);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    for (int i = 0; i < lod->vertexCount; i++)
+    {
+        Vector3 v = lod->vertices[i];
+        rlVertex3f(center.x + v.x*radius, center.y + v.y*radius, center.z + v.z*radius);
+    }
+    rlEnd();
+}
+void DrawTargetSpheres(const float *x, const float *y, const float *z, unsigned char *lod, int count, float radius, Color color)
+{
+    // inside BeginMode3D with the global camera, lod keeps each target's level from the frame before
+    if (culling.lods[0].vertices == NULL) InitSphereLods();
+    if (count > culling.capacity)
+    {
+        culling.capacity = count;
+        culling.entries = realloc(culling.entries, count*sizeof(CullEntry));
+    }
+    ViewFrustum frustum = GetViewFrustum(camera, (float)screenWidth/screenHeight);
+    int drawn = count;
+    if (culling.enabled) drawn = CullSpheres(&frustum, x, y, z, count, radius, culling.entries);
+    else
+    {
+        for (int i = 0; i < count; i++)
+            culling.entries[i] = (CullEntry){ .depth = Vector3DotProduct(Vector3Subtract((Vector3){ x[i], y[i], z[i] }, frustum.position), frustum.forward), .index = i };
+    }
+    if (culling.depthSort) qsort(culling.entries, drawn, sizeof(CullEntry), CompareCullDepth);
+
+    // radius in pixels of the 3D layer is the world radius over depth, scaled by the projection
+    float pixelScale = sceneLayer.viewHeight*0.5f/tanf(camera.fovy*0.5f*DEG2RAD);
+    for (int i = 0; i < drawn; i++)
+    {
+        int index = culling.entries[i].index;
+        float depth = fmaxf(culling.entries[i].depth, RL_CULL_DISTANCE_NEAR);
+        int level = SelectSphereLod(radius*pixelScale/depth, lod[index]);
+        lod[index] = level;
+        renderStats.current.targetsPerLod[level]++;
+        DrawSphereLod(&culling.lods[level], (Vector3){ x[index], y[index], z[index] }, radius, color);
+    }
+    renderStats.current.targetsTested += count;
+    renderStats.current.targetsDrawn += drawn;
+}
+void DrawTargetHumanoids(const float *x, const float *y, const float *z, unsigned char *lod, int count, float scale, Color color)
+{
+    // culled and leveled by the bounding sphere, the capsules take their rings and slices from the sphere levels
+    const HumanoidHitbox *hb = &humanoidHitbox;
+    if (count > culling.capacity)
+    {
+        culling.capacity = count;
+        culling.entries = realloc(culling.entries, count*sizeof(CullEntry));
+    }
+    float radius = hb->boundRadius*scale;
+    ViewFrustum frustum = GetViewFrustum(camera, (float)screenWidth/screenHeight);
+    int drawn = count;
+    if (culling.enabled) drawn = CullSpheres(&frustum, x, y, z, count, radius, culling.entries);
+    else
+    {
+        for (int i = 0; i < count; i++)
+            culling.entries[i] = (CullEntry){ .depth = Vector3DotProduct(Vector3Subtract((Vector3){ x[i], y[i], z[i] }, frustum.position), frustum.forward), .index = i };
+    }
+    if (culling.depthSort) qsort(culling.entries, drawn, sizeof(CullEntry), CompareCullDepth);
+
+    float pixelScale = sceneLayer.viewHeight*0.5f/tanf(camera.fovy*0.5f*DEG2RAD);
+    Color head = ColorBrightness(color, -0.3f);
+    for (int i = 0; i < drawn; i++)
+    {
+        int index = culling.entries[i].index;
+        float depth = fmaxf(culling.entries[i].depth, RL_CULL_DISTANCE_NEAR);
+        int level = SelectSphereLod(radius*pixelScale/depth, lod[index]);
+        lod[index] = level;
+        renderStats.current.targetsPerLod[level]++;
+        Vector3 position = { x[index], y[index], z[index] };
+        for (int s = 0; s < HUMANOID_SHAPES; s++)
+        {
+            const HitboxShape *shape = &hb->shapes[s];
+            Vector3 a = Vector3Add(position, Vector3Scale(shape->a, scale));
+            Vector3 b = Vector3Add(position, Vector3Scale(shape->b, scale));
+            if (shape->box) DrawCubeV(Vector3Lerp(a, b, 0.5f), Vector3Subtract(b, a), color);
+            else DrawCapsule(a, b, shape->radius*scale, sphereLodSlices[level], sphereLodRings[level], shape->part == HITBOX_HEAD ? head : color);
+        }
+    }
+    renderStats.current.targetsTested += count;
+    renderStats.current.targetsDrawn += drawn;
+}
+#pragma endregion
+#pragma region GPU Picking
+#if !defined(PLATFORM_WEB)
+static const char *pickVertexShader =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in vec4 vertexColor;\n"
+    "uniform mat4 mvp;\n"
+    "flat out uint pickId;\n"
+    "void main()\n"
+    "{\n"
+    "    // slot + 1 in red, part + 1 in green, exact after the round trip through normalized bytes\n"
+    "    uvec2 id = uvec2(round(vertexColor.rg*255.0));\n"
+    "    pickId = id.x | (id.y << 8);\n"
+    "    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+    "}\n";
+static const char *pickFragmentShader =
+    "#version 330\n"
+    "flat in uint pickId;\n"
+    "layout(location = 0) out uint finalId;\n"
+    "void main()\n"
+    "{\n"
+    "    finalId = pickId;\n"
+    "}\n";
+#endif
+bool InitGpuPicking()
+{
+#if !defined(PLATFORM_WEB)
+    if (picking.supported) return true;
+    picking.shader = LoadShaderFromMemory(pickVertexShader, pickFragmentShader);
+    if (!IsShaderValid(picking.shader))
+    {
+        TraceLog(LOG_WARNING, "PICK: Failed to build the ID shader, GPU picking disabled");
+        return false;
+    }
+    glGenTextures(1, &picking.texture);
+    glBindTexture(GL_TEXTURE_2D, picking.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, GPU_PICK_SIZE, GPU_PICK_SIZE, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    picking.framebuffer = rlLoadFramebuffer();
+    rlFramebufferAttach(picking.framebuffer, picking.texture, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(picking.framebuffer, rlLoadTextureDepth(GPU_PICK_SIZE, GPU_PICK_SIZE, true), RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+    if (!rlFramebufferComplete(picking.framebuffer))
+    {
+        TraceLog(LOG_WARNING, "PICK: ID framebuffer incomplete, GPU picking disabled");
+        rlUnloadFramebuffer(picking.framebuffer);
+        glDeleteTextures(1, &picking.texture);
+        UnloadShader(picking.shader);
+        picking = (GpuPicking){ 0 };
+        return false;
+    }
+    // one pixel per readback, a few in flight so a click never waits on the one before it
+    glGenBuffers(GPU_PICK_READBACKS, picking.buffers);
+    for (int i = 0; i < GPU_PICK_READBACKS; i++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, picking.buffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(unsigned int), NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    picking.supported = true;
+    return true;
+#else
+    return false;
+#endif
+}
+void UnloadGpuPicking()
+{
+#if !defined(PLATFORM_WEB)
+    if (!picking.supported) return;
+    for (int i = 0; i < GPU_PICK_READBACKS; i++)
+        if (picking.pending[i].fence != NULL) glDeleteSync(picking.pending[i].fence);
+    glDeleteBuffers(GPU_PICK_READBACKS, picking.buffers);
+    rlUnloadFramebuffer(picking.framebuffer);
+    glDeleteTextures(1, &picking.texture);
+    UnloadShader(picking.shader);
+    picking = (GpuPicking){ 0 };
+#endif
+}
+void SetGpuPickingEnabled(bool enabled)
+{
+    picking.enabled = enabled && InitGpuPicking();
+}
+#if !defined(PLATFORM_WEB)
+static GpuPickRequest GetAnalyticPick(const ReactionGame *game, const Camera *view)
+{
+    // the analytic answer for exactly the shapes the ID pass draws, humanoids without the hit padding so parts stay comparable
+    Ray ray = { view->position, Vector3Normalize(Vector3Subtract(view->target, view->position)) };
+    GpuPickRequest request = { 0 };
+    request.humanoid = game->rules.humanoid;
+    for (int i = 0; i < game->targetCount; i++)
+    {
+        Vector3 p = GetReactionTarget(game, i);
+        if (game->rules.humanoid)
+        {
+            int part = RaycastHumanoid(ray, p, game->ballSize*HUMANOID_SCALE, 0.0f);
+            if (part < 0) continue;
+            request.hits |= 1 << i;
+            request.parts[i] = part;
+        }
+        else if (GetRayCollisionSphere(ray, p, game->ballSize + game->rules.hitPadding).hit) request.hits |= 1 << i;
+    }
+    return request;
+}
+#endif
+void RequestGpuPick(const ReactionGame *game, const Camera *view)
+{
+#if !defined(PLATFORM_WEB)
+    if (!picking.enabled) return;
+    GpuPickRequest *request = &picking.pending[picking.next];
+    if (request->fence != NULL)
+    {
+        // a full ring of clicks and the oldest still isn't back, forget it rather than wait
+        glDeleteSync(request->fence);
+        picking.dropped++;
+    }
+    *request = GetAnalyticPick(game, view);
+    request->frame = renderStats.frame;
+    picking.next = (picking.next + 1) % GPU_PICK_READBACKS;
+
+    // a projection that covers only the GPU_PICK_SIZE window pixels around the crosshair
+    rlDrawRenderBatchActive();
+    rlEnableFramebuffer(picking.framebuffer);
+    rlViewport(0, 0, GPU_PICK_SIZE, GPU_PICK_SIZE);
+    static const unsigned int noTarget[4] = { 0 };
+    static const float farDepth = 1.0f;
+    glClearBufferuiv(GL_COLOR, 0, noTarget);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+    double half = RL_CULL_DISTANCE_NEAR*tan(view->fovy*0.5*DEG2RAD)*GPU_PICK_SIZE/screenHeight;
+    rlMatrixMode(RL_PROJECTION);
+    rlPushMatrix();
+    rlLoadIdentity();
+    rlFrustum(-half, half, -half, half, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    rlMatrixMode(RL_MODELVIEW);
+    rlPushMatrix();
+    rlLoadIdentity();
+    rlMultMatrixf(MatrixToFloat(GetCameraMatrix(*view)));
+    rlEnableDepthTest();
+    rlDisableColorBlend();
+    BeginShaderMode(picking.shader);
+    if (culling.lods[0].vertices == NULL) InitSphereLods();
+    const HumanoidHitbox *hb = &humanoidHitbox;
+    for (int i = 0; i < game->targetCount; i++)
+    {
+        Vector3 p = GetReactionTarget(game, i);
+        if (!game->rules.humanoid)
+        {
+            DrawSphereLod(&culling.lods[SPHERE_LOD_LEVELS - 1], p, game->ballSize + game->rules.hitPadding, (Color){ i + 1, 0, 0, 255 });
+            continue;
+        }
+        float scale = game->ballSize*HUMANOID_SCALE;
+        for (int s = 0; s < HUMANOID_SHAPES; s++)
+        {
+            const HitboxShape *shape = &hb->shapes[s];
+            Color id = { i + 1, shape->part + 1, 0, 255 };
+            Vector3 a = Vector3Add(p, Vector3Scale(shape->a, scale));
+            Vector3 b = Vector3Add(p, Vector3Scale(shape->b, scale));
+            if (shape->box) DrawCubeV(Vector3Lerp(a, b, 0.5f), Vector3Subtract(b, a), id);
+            else DrawCapsule(a, b, shape->radius*scale, 16, 16, id);
+        }
+    }
+    EndShaderMode();
+    rlEnableColorBlend();
+    rlDisableDepthTest();
+    rlMatrixMode(RL_PROJECTION);
+    rlPopMatrix();
+    rlMatrixMode(RL_MODELVIEW);
+    rlPopMatrix();
+
+    // only the centre pixel, into a pack buffer so the copy happens whenever the GPU gets to it
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, picking.buffers[request - picking.pending]);
+    glReadPixels(GPU_PICK_SIZE/2, GPU_PICK_SIZE/2, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    request->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    rlDisableFramebuffer();
+    rlViewport(0, 0, rlGetFramebufferWidth(), rlGetFramebufferHeight());
+#endif
+}
+void UpdateGpuPicking()
+{
+#if !defined(PLATFORM_WEB)
+    if (!picking.supported) return;
+    for (int i = 0; i < GPU_PICK_READBACKS; i++)
+    {
+        GpuPickRequest *request = &picking.pending[i];
+        if (request->fence == NULL) continue;
+        // a zero timeout only asks, it never blocks the frame
+        unsigned int status = glClientWaitSync(request->fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+        glDeleteSync(request->fence);
+        request->fence = NULL;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, picking.buffers[i]);
+        const unsigned int *pixel = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(unsigned int), GL_MAP_READ_BIT);
+        unsigned int id = pixel != NULL ? *pixel : 0;
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // agrees when the front target in the ID buffer is one the rays hit, and on the same part
+        int slot = (int)(id & 0xff) - 1;
+        int part = (int)(id >> 8) - 1;
+        bool agree = slot < 0 ? request->hits == 0 :
+                     slot < NUM_BALLS_ON_SCREEN && (request->hits & (1 << slot)) && (!request->humanoid || request->parts[slot] == part);
+        picking.checked++;
+        if (agree) picking.agreed++;
+        else TraceLog(LOG_DEBUG, "PICK: GPU picked slot %d part %d, rays hit mask %d", slot, part, request->hits);
+        picking.latency = renderStats.frame - request->frame;
+    }
+#endif
+}
+void DrawGpuPicking()
+{
+    if (!picking.enabled) return;
+    DrawUiText(TextFormat("gpu pick  agreed %u of %u clicks  %u frames late  %u dropped", picking.agreed, picking.checked, picking.latency, picking.dropped),
+               4, screenHeight - 70, 10, GRAY);
+}
+#pragma endregion
+#pragma region Benchmark
+void DrawBenchTargets()
+{
+    const float *x = bench.targetX;
+    const float *y = bench.targetY;
+    if (bench.motion.count > 0)
+    {
+        const float *dx = bench.motion.fields + MOTION_X*bench.motion.capacity;
+        const float *dy = bench.motion.fields + MOTION_Y*bench.motion.capacity;
+        for (int i = 0; i < bench.targetCount; i++)
+        {
+            bench.movedX[i] = x[i] + dx[i];
+            bench.movedY[i] = y[i] + dy[i];
+        }
+        x = bench.movedX;
+        y = bench.movedY;
+    }
+    DrawTargetSpheres(x, y, bench.targetZ, bench.lod, bench.targetCount, reactionGame.ballSize, reactionGame.ballColor);
+}
+#if !defined(PLATFORM_WEB)
+static const BenchScene benchScenes[] = {
+    { .name = "main_menu", .appState = MAIN, .gameState = START, .targets = 0, .bgWidth = 1920, .bgHeight = 1080 },
+    { .name = "reaction_menu", .appState = REACTION, .gameState = START, .targets = 0, .bgWidth = 1920, .bgHeight = 1080 },
+    { .name = "hud_3_targets", .appState = REACTION, .gameState = PLAY, .targets = 3, .bgWidth = 1920, .bgHeight = 1080 },
+    { .name = "targets_100", .appState = REACTION, .gameState = PLAY, .targets = 100, .bgWidth = 1920, .bgHeight = 1080 },
+    { .name = "targets_1000", .appState = REACTION, .gameState = PLAY, .targets = 1000, .bgWidth = 1920, .bgHeight = 1080 },
+    { .name = "targets_10000", .appState = REACTION, .gameState = PLAY, .targets = 10000, .bgWidth = 1920, .bgHeight = 1080 },
+    { .name = "background_1440p", .appState = REACTION, .gameState = PLAY, .targets = 3, .bgWidth = 2560, .bgHeight = 1440 },
+    { .name = "background_4k", .appState = REACTION, .gameState = PLAY, .targets = 3, .bgWidth = 3840, .bgHeight = 2160 },
+    { .name = "background_5k", .appState = REACTION, .gameState = PLAY, .targets = 3, .bgWidth = 5120, .bgHeight = 2880 },
+    { .name = "targets_10000_background_5k", .appState = REACTION, .gameState = PLAY, .targets = 10000, .bgWidth = 5120, .bgHeight = 2880 },
+    { .name = "moving_1000", .appState = REACTION, .gameState = PLAY, .targets = 1000, .bgWidth = 1920, .bgHeight = 1080, .motion = MOTION_MIXED },
+    { .name = "moving_10000", .appState = REACTION, .gameState = PLAY, .targets = 10000, .bgWidth = 1920, .bgHeight = 1080, .motion = MOTION_MIXED },
+};
+static const int benchSceneCount = sizeof(benchScenes)/sizeof(benchScenes[0]);
+static double ThreadCpuSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+static long PeakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss/1024;    // bytes on macOS, kilobytes everywhere else
+#else
+    return usage.ru_maxrss;
+#endif
+}
+static void WriteJsonString(FILE *f, const char *text)
+{
+    fputc('"', f);
+    for (const char *c = text != NULL ? text : ""; *c; c++)
+    {
+        if (*c == '"' || *c == '\\') fputc('\\', f);
+        if ((unsigned char)*c >= 0x20) fputc(*c, f);
+    }
+    fputc('"', f);
+}
+static void WriteBenchPercentiles(FILE *f, const char *name, double *samples, int count)
+{
+    fprintf(f, "      \"%s\": ", name);
+    if (count == 0)
+    {
+        fprintf(f, "null");
+        return;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += samples[i];
+    qsort(samples, count, sizeof(double), CompareSeconds);
+    #define BENCH_PERCENTILE(p) samples[(int)((p)*(count - 1) + 0.5)]
+    fprintf(f, "{ \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f }",
+            sum/count, BENCH_PERCENTILE(0.5), BENCH_PERCENTILE(0.9), BENCH_PERCENTILE(0.99), samples[count - 1]);
+    #undef BENCH_PERCENTILE
+}
+static void SetupBenchScene(const BenchScene *scene)
+{
+    // same seed every run so every build draws the same thing
+    SetRandomSeed(1);
+    game.appState = scene->appState;
+    reactionGame.gameState = scene->gameState;
+    reactionGame.hideGame = false;
+    if (scene->gameState == PLAY)
+    {
+        reactionGame.ballColor = ballColors[reactionStart.ballColorIndex];
+        reactionGame.ballSize = 4;
+        ResetReactionGame();
+    }
+
+    // the rest of the targets spread through the view behind the game's grid
+    bench.targetCount = scene->targets > REACTION_TARGETS ? scene->targets - REACTION_TARGETS : 0;
+    for (int i = 0; i < bench.targetCount; i++)
+    {
+        bench.targetX[i] = GetRandomValue(-400, 400);
+        bench.targetY[i] = GetRandomValue(-250, 250);
+        bench.targetZ[i] = GetRandomValue(500, 900);
+    }
+    bench.motion.count = scene->motion != MOTION_STATIC ? bench.targetCount : 0;
+    unsigned int random = 1;
+    for (int i = 0; i < bench.motion.count; i++) SpawnTargetMotion(&bench.motion, i, scene->motion, &random);
+
+    Image image = GenImageGradientLinear(scene->bgWidth, scene->bgHeight, 45, SKYBLUE, DARKBLUE);
+    bgImage.bg_texture = LoadTextureFromImage(image);
+    bgImage.bg_source_rect = (Rectangle){ 0, 0, scene->bgWidth, scene->bgHeight };
+    bgImage.image_loaded = bgImage.bg_texture.id > 0;
+    UnloadImage(image);
+}
+static void BenchFrame(int frame)
+{
+    // scripted camera sweep, the mouse is ignored so nobody can skew a run by touching it
+    reactionStart.mouseSensitivity = 0.0f;
+    reactionGame.timer = 30;
+    camSettings.yaw = sinf(frame*0.02f)*0.4f;
+    camSettings.pitch = sinf(frame*0.013f)*0.2f;
+    for (int i = 0; i < BENCH_MOTION_TICKS && bench.motion.count > 0; i++) StepTargetMotion(&bench.motion);
+    UpdateGame();
+}
+int RunBenchmark()
+{
+    FILE *report = fopen(bench.reportPath, "w");
+    if (report == NULL)
+    {
+        TraceLog(LOG_WARNING, "BENCH: [%s] Failed to open report", bench.reportPath);
+        return 1;
+    }
+    if (bench.frames < 1) bench.frames = 1;
+    int maxTargets = 0;
+    for (int i = 0; i < benchSceneCount; i++)
+        if (benchScenes[i].targets > maxTargets) maxTargets = benchScenes[i].targets;
+    bench.targetX = malloc(maxTargets*sizeof(float));
+    bench.targetY = malloc(maxTargets*sizeof(float));
+    bench.targetZ = malloc(maxTargets*sizeof(float));
+    bench.movedX = malloc(maxTargets*sizeof(float));
+    bench.movedY = malloc(maxTargets*sizeof(float));
+    bench.lod = calloc(maxTargets, 1);
+    bench.motion.capacity = (maxTargets + 3) & ~3;
+    bench.motion.fields = calloc(MOTION_FIELD_COUNT*bench.motion.capacity, sizeof(float));
+    bench.motion.random = calloc(bench.motion.capacity, sizeof(unsigned int));
+    bench.gpuMs = malloc(bench.frames*sizeof(double));
+    double *frameMs = malloc(bench.frames*sizeof(double));
+    double *cpuMs = malloc(bench.frames*sizeof(double));
+    SetGpuTimersEnabled(true);
+    bench.running = true;
+
+    fprintf(report, "{\n  \"version\": 1,\n  \"build\": \"%s %s\",\n  \"renderer\": ", __DATE__, __TIME__);
+    WriteJsonString(report, (const char *)glGetString(GL_RENDERER));
+    fprintf(report, ",\n  \"gl_version\": ");
+    WriteJsonString(report, (const char *)glGetString(GL_VERSION));
+    fprintf(report, ",\n  \"cpus\": %ld,\n  \"window\": [%d, %d],\n  \"gpu_timers\": %s,\n  \"scenes\": [\n",
+            sysconf(_SC_NPROCESSORS_ONLN), GetScreenWidth(), GetScreenHeight(), gpuTimers.supported ? "true" : "false");
+
+    bool aborted = false;
+    int frame = 0;
+    for (int s = 0; s < benchSceneCount && !aborted; s++)
+    {
+        const BenchScene *scene = &benchScenes[s];
+        SetupBenchScene(scene);
+        for (int i = 0; i < BENCH_WARMUP_FRAMES && !aborted; i++)
+        {
+            BenchFrame(frame++);
+            aborted = WindowShouldClose();
+        }
+
+        bench.gpuCount = 0;
+        bench.gpuFirstFrame = gpuTimers.frame;
+        bench.gpuEndFrame = UINT_MAX;
+        unsigned long long drawCalls = 0, vertices = 0, targetsDrawn = 0;
+        int measured = 0;
+        double sceneStart = ClockSeconds();
+        while (measured < bench.frames && !aborted && ClockSeconds() - sceneStart < BENCH_SCENE_SECONDS)
+        {
+            double start = ClockSeconds();
+            double cpuStart = ThreadCpuSeconds();
+            BenchFrame(frame++);
+            cpuMs[measured] = (ThreadCpuSeconds() - cpuStart)*1000.0;
+            frameMs[measured] = (ClockSeconds() - start)*1000.0;
+            drawCalls += renderStats.last.drawCalls;
+            vertices += renderStats.last.vertices;
+            targetsDrawn += renderStats.last.targetsDrawn;
+            measured++;
+            aborted = WindowShouldClose();
+        }
+        double sceneSeconds = ClockSeconds() - sceneStart;
+        // a few more frames bring back the timestamps still in flight
+        bench.gpuEndFrame = gpuTimers.frame;
+        for (int i = 0; i < 2*GPU_TIMER_FRAMES && gpuTimers.supported && bench.gpuCount < measured && !aborted; i++) BenchFrame(frame++);
+
+        long textureKb = ((long)scene->bgWidth*scene->bgHeight*4 + (long)sceneLayer.target.texture.width*sceneLayer.target.texture.height*4)/1024;
+        fprintf(report, "    {\n      \"name\": \"%s\",\n      \"targets\": %d,\n      \"background\": [%d, %d],\n"
+                "      \"frames\": %d,\n      \"seconds\": %.3f,\n",
+                scene->name, scene->targets, scene->bgWidth, scene->bgHeight, measured, sceneSeconds);
+        WriteBenchPercentiles(report, "frame_ms", frameMs, measured);
+        fprintf(report, ",\n");
+        WriteBenchPercentiles(report, "cpu_ms", cpuMs, measured);
+        fprintf(report, ",\n");
+        WriteBenchPercentiles(report, "gpu_ms", bench.gpuMs, bench.gpuCount);
+        fprintf(report, ",\n      \"draw_calls\": %.1f,\n      \"vertices\": %.0f,\n      \"targets_drawn\": %.1f,\n      \"texture_kb\": %ld,\n      \"peak_rss_kb\": %ld\n    }%s\n",
+                measured > 0 ? (double)drawCalls/measured : 0.0, measured > 0 ? (double)vertices/measured : 0.0,
+                measured > 0 ? (double)targetsDrawn/measured : 0.0,
+                textureKb, PeakRssKb(), s + 1 < benchSceneCount && !aborted ? "," : "");
+        TraceLog(LOG_INFO, "BENCH: %s, %d frames, %.2f ms mean", scene->name, measured, measured > 0 ? sceneSeconds*1000.0/measured : 0.0);
+
+        UnloadTexture(bgImage.bg_texture);
+        bgImage.bg_texture = (Texture2D){ 0 };
+        bgImage.image_loaded = false;
+    }
+    fprintf(report, "  ],\n  \"aborted\": %s,\n  \"peak_rss_kb\": %ld\n}\n", aborted ? "true" : "false", PeakRssKb());
+    fclose(report);
+    TraceLog(LOG_INFO, "BENCH: [%s] Report written", bench.reportPath);
+
+    bench.running = false;
+    bench.targetCount = 0;
+    free(bench.targetX);
+    free(bench.targetY);
+    free(bench.targetZ);
+    free(bench.movedX);
+    free(bench.movedY);
+    free(bench.lod);
+    free(bench.motion.fields);
+    free(bench.motion.random);
+    bench.motion = (TargetMotion){ 0 };
+    free(bench.gpuMs);
+    free(frameMs);
+    free(cpuMs);
+    return aborted ? 1 : 0;
+}
+#endif
+#pragma endregion
+#pragma region Live Background
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+static atomic_int liveXError;
+static Display *_Atomic liveXDisplay;       // the capture thread's connection, errors on any other are not ours
+static XErrorHandler liveXPrevious;
+static int LiveXErrorHandler(Display *display, XErrorEvent *event)
+{
+    // Xlib's handler is process wide, everyone else's errors go where they went before
+    if (event->display != atomic_load(&liveXDisplay)) return liveXPrevious != NULL ? liveXPrevious(display, event) : 0;
+    // a captured window going away must not take the whole app down with Xlib's default handler
+    atomic_store(&liveXError, event->error_code);
+    return 0;
+}
+static bool CreateLiveShmImage(Display *display, Visual *visual, int depth, int width, int height, XShmSegmentInfo *shm, XImage **image)
+{
+    *image = XShmCreateImage(display, visual, depth, ZPixmap, NULL, shm, width, height);
+    if (*image == NULL) return false;
+    if ((*image)->bits_per_pixel != 32)
+    {
+        XDestroyImage(*image);
+        *image = NULL;
+        return false;
+    }
+    shm->shmid = shmget(IPC_PRIVATE, (size_t)(*image)->bytes_per_line*height, IPC_CREAT | 0600);
+    shm->shmaddr = (*image)->data = shmat(shm->shmid, NULL, 0);
+    shm->readOnly = False;
+    bool ok = shm->shmaddr != (char *)-1 && XShmAttach(display, shm);
+    XSync(display, False);
+    // marked for removal right away so a crash never leaks the segment
+    shmctl(shm->shmid, IPC_RMID, NULL);
+    if (!ok || atomic_load(&liveXError))
+    {
+        if (shm->shmaddr != (char *)-1) shmdt(shm->shmaddr);
+        (*image)->data = NULL;
+        XDestroyImage(*image);
+        *image = NULL;
+        return false;
+    }
+    return true;
+}
+static void DestroyLiveShmImage(Display *display, XShmSegmentInfo *shm, XImage **image)
+{
+    if (*image == NULL) return;
+    XShmDetach(display, shm);
+    shmdt(shm->shmaddr);
+    (*image)->data = NULL;
+    XDestroyImage(*image);
+    *image = NULL;
+}
+static void *LiveCaptureThread(void *arg)
+{
+    LiveBackground *live = arg;
+    Display *display = XOpenDisplay(NULL);
+    atomic_store(&liveXDisplay, display);
+    bool ok = display != NULL && XShmQueryExtension(display);
+    int event, error;
+    if (ok && live->window != 0) ok = XCompositeQueryExtension(display, &event, &error);
+    // redirected windows keep rendering offscreen, so the work app can sit fully behind us
+    if (ok && live->window != 0) XCompositeRedirectWindow(display, live->window, CompositeRedirectAutomatic);
+
+    XShmSegmentInfo shm = { 0 };
+    XImage *image = NULL;
+    Pixmap pixmap = 0;
+    int pixmapWidth = 0, pixmapHeight = 0;
+    while (ok)
+    {
+        pthread_mutex_lock(&live->lock);
+        while (atomic_load(&live->state) != LIVE_CAPTURING && !atomic_load(&live->quit)) pthread_cond_wait(&live->wake, &live->lock);
+        pthread_mutex_unlock(&live->lock);
+        if (atomic_load(&live->quit)) break;
+
+        struct timespec cpuStart, cpuEnd;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
+        double start = ClockSeconds();
+
+        // work out what to read this time, windows can be resized between captures
+        XWindowAttributes attributes;
+        Drawable source;
+        int x = 0, y = 0, width, height;
+        if (live->window != 0)
+        {
+            if (!XGetWindowAttributes(display, live->window, &attributes)) { ok = false; break; }
+            width = attributes.width;
+            height = attributes.height;
+            if (pixmap == 0 || width != pixmapWidth || height != pixmapHeight)
+            {
+                if (pixmap != 0) XFreePixmap(display, pixmap);
+                pixmap = XCompositeNameWindowPixmap(display, live->window);
+                pixmapWidth = width;
+                pixmapHeight = height;
+            }
+            source = pixmap;
+        }
+        else
+        {
+            Window root = DefaultRootWindow(display);
+            XGetWindowAttributes(display, root, &attributes);
+            source = root;
+            Rectangle screen = { 0, 0, attributes.width, attributes.height };
+            Rectangle region = live->region.width > 0 && live->region.height > 0 ? GetCollisionRec(live->region, screen) : screen;
+            x = region.x;
+            y = region.y;
+            width = region.width;
+            height = region.height;
+        }
+        if (width <= 0 || height <= 0) { ok = false; break; }
+        if (image == NULL || image->width != width || image->height != height || image->depth != attributes.depth)
+        {
+            DestroyLiveShmImage(display, &shm, &image);
+            if (!CreateLiveShmImage(display, attributes.visual, attributes.depth, width, height, &shm, &image)) { ok = false; break; }
+        }
+
+        // the main thread mapped a pixel unpack buffer for us, rows go straight into it
+        if (live->target != NULL)
+        {
+            XShmGetImage(display, source, image, x, y, AllPlanes);
+            XSync(display, False);
+            if (atomic_load(&liveXError)) { ok = false; break; }
+            int rows = height < live->targetHeight ? height : live->targetHeight;
+            size_t rowBytes = (size_t)(width < live->targetWidth ? width : live->targetWidth)*4;
+            for (int row = 0; row < rows; row++)
+                memcpy(live->target + (size_t)row*live->targetWidth*4, image->data + (size_t)row*image->bytes_per_line, rowBytes);
+        }
+        live->capturedWidth = width;
+        live->capturedHeight = height;
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+        live->captureSeconds = (float)(ClockSeconds() - start);
+        live->captureCpuSeconds = (float)((cpuEnd.tv_sec - cpuStart.tv_sec) + (cpuEnd.tv_nsec - cpuStart.tv_nsec)*1e-9);
+        atomic_store(&live->state, LIVE_READY);
+    }
+    if (!ok) atomic_store(&live->state, LIVE_FAILED);
+
+    if (display != NULL)
+    {
+        DestroyLiveShmImage(display, &shm, &image);
+        if (pixmap != 0) XFreePixmap(display, pixmap);
+        if (live->window != 0 && !atomic_load(&liveXError)) XCompositeUnredirectWindow(display, live->window, CompositeRedirectAutomatic);
+        // flushed while still ours, the close can not raise anything after this
+        XSync(display, False);
+        atomic_store(&liveXDisplay, NULL);
+        XCloseDisplay(display);
+    }
+    return NULL;
+}
+static void ResizeLiveBackground(LiveBackground *live, int width, int height)
+{
+    if (live->texture.id > 0) rlUnloadTexture(live->texture.id);
+    if (live->pbo[0] != 0) glDeleteBuffers(2, live->pbo);
+    live->texture = (Texture2D){ rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    // X hands us BGRX, the upload swaps channels on the GPU and the padding byte is never read as alpha
+    glBindTexture(GL_TEXTURE_2D, live->texture.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_ONE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenBuffers(2, live->pbo);
+    for (int i = 0; i < 2; i++)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, live->pbo[i]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (ptrdiff_t)width*height*4, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    live->hasFrame = false;
+}
+#endif
+void StartLiveBackground()
+{
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    if (liveBg.enabled) return;
+    if (getenv("DISPLAY") == NULL)
+    {
+        TraceLog(LOG_WARNING, "LIVE: Live background needs an X11 display");
+        return;
+    }
+    atomic_store(&liveXError, 0);
+    atomic_store(&liveXDisplay, NULL);
+    liveXPrevious = XSetErrorHandler(LiveXErrorHandler);
+    atomic_store(&liveBg.state, LIVE_IDLE);
+    atomic_store(&liveBg.quit, false);
+    liveBg.target = NULL;
+    liveBg.nextCapture = 0.0;
+    liveBg.interval = LIVE_MIN_INTERVAL;
+    pthread_mutex_init(&liveBg.lock, NULL);
+    pthread_cond_init(&liveBg.wake, NULL);
+    if (pthread_create(&liveBg.thread, NULL, LiveCaptureThread, &liveBg) != 0)
+    {
+        TraceLog(LOG_WARNING, "LIVE: Failed to start capture thread");
+        XSetErrorHandler(liveXPrevious);
+        return;
+    }
+    liveBg.enabled = true;
+    TraceLog(LOG_INFO, "LIVE: Capturing %s", liveBg.window != 0 ? TextFormat("window 0x%lx", liveBg.window) : "the screen");
+#else
+    TraceLog(LOG_WARNING, "LIVE: Live background is only available on X11");
+#endif
+}
+void StopLiveBackground()
+{
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    if (!liveBg.enabled) return;
+    pthread_mutex_lock(&liveBg.lock);
+    atomic_store(&liveBg.quit, true);
+    pthread_cond_signal(&liveBg.wake);
+    pthread_mutex_unlock(&liveBg.lock);
+    pthread_join(liveBg.thread, NULL);
+    pthread_mutex_destroy(&liveBg.lock);
+    pthread_cond_destroy(&liveBg.wake);
+    XSetErrorHandler(liveXPrevious);
+
+    if (liveBg.target != NULL)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, liveBg.pbo[liveBg.pboIndex]);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        liveBg.target = NULL;
+    }
+    if (liveBg.texture.id > 0) rlUnloadTexture(liveBg.texture.id);
+    if (liveBg.pbo[0] != 0) glDeleteBuffers(2, liveBg.pbo);
+    liveBg.texture = (Texture2D){ 0 };
+    liveBg.pbo[0] = liveBg.pbo[1] = 0;
+    liveBg.hasFrame = false;
+    liveBg.enabled = false;
+#endif
+}
+void UpdateLiveBackground()
+{
+#if defined(__linux__) && !defined(PLATFORM_WEB)
+    if (!liveBg.enabled) return;
+    int state = atomic_load(&liveBg.state);
+    if (state == LIVE_FAILED)
+    {
+        TraceLog(LOG_WARNING, "LIVE: Capture failed, back to the static background");
+        StopLiveBackground();
+        return;
+    }
+    double now = ClockSeconds();
+    if (state == LIVE_READY)
+    {
+        if (liveBg.target != NULL)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, liveBg.pbo[liveBg.pboIndex]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            liveBg.target = NULL;
+            if (liveBg.capturedWidth == liveBg.texture.width && liveBg.capturedHeight == liveBg.texture.height)
+            {
+                // sourced from the bound unpack buffer, the copy runs on the GPU's time and the other buffer takes the next capture
+                glBindTexture(GL_TEXTURE_2D, liveBg.texture.id);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, liveBg.texture.width, liveBg.texture.height, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                liveBg.hasFrame = true;
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            liveBg.pboIndex ^= 1;
+        }
+        if (liveBg.capturedWidth != liveBg.texture.width || liveBg.capturedHeight != liveBg.texture.height)
+            ResizeLiveBackground(&liveBg, liveBg.capturedWidth, liveBg.capturedHeight);
+
+        // capture cost decides the rate, never more than the CPU budget of one core
+        liveBg.interval = fmax(LIVE_MIN_INTERVAL, liveBg.captureCpuSeconds / LIVE_CPU_BUDGET);
+        liveBg.cpuPercent = 100.0f*liveBg.captureCpuSeconds / liveBg.interval;
+        atomic_store(&liveBg.state, LIVE_IDLE);
+        state = LIVE_IDLE;
+    }
+    if (state == LIVE_IDLE && now >= liveBg.nextCapture)
+    {
+        if (liveBg.texture.id > 0)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, liveBg.pbo[liveBg.pboIndex]);
+            liveBg.target = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (ptrdiff_t)liveBg.texture.width*liveBg.texture.height*4, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            liveBg.targetWidth = liveBg.texture.width;
+            liveBg.targetHeight = liveBg.texture.height;
+        }
+        liveBg.nextCapture = now + liveBg.interval;
+        pthread_mutex_lock(&liveBg.lock);
+        atomic_store(&liveBg.state, LIVE_CAPTURING);
+        pthread_cond_signal(&liveBg.wake);
+        pthread_mutex_unlock(&liveBg.lock);
+    }
+#endif
+}
+void DrawLiveBackgroundStats()
+{
+    if (!liveBg.enabled) return;
+    DrawUiText(TextFormat("live %.1f Hz  %.1f ms  %.1f%% cpu", 1.0/liveBg.interval, liveBg.captureSeconds*1000.0f, liveBg.cpuPercent), 4, screenHeight - 14, 10, GRAY);
+}
+#pragma endregion
+#pragma region Main Loops
+void UpdateAndDrawApp()
+{
+    switch (game.appState)
+    {
+    case MAIN:
+        DrawMainMenu();
+        break;
+    case REACTION:
+        UpdateReactionGameState();
+        break;
+    case TRACK:
+        UpdateTrackGame();
+        DrawTrackGame();
+        break;
+    case REPLAY:
+        UpdateReplayViewer();
+        if (game.appState == REPLAY) DrawReplayViewer();
+        break;
+    
+    default:
+        break;
+    }
+}
+void UpdateLayout()
+{
+    // menu geometry only depends on the window size, rebuild it when that changes instead of every frame
+    if (uiLayout.width == screenWidth && uiLayout.height == screenHeight) return;
+    uiLayout.width = screenWidth;
+    uiLayout.height = screenHeight;
+    bgImage.bg_dest_rect.width = screenWidth;
+    bgImage.bg_dest_rect.height = screenHeight;
+    LayoutMainMenu();
+    LayoutReactionStartMenu();
+    LayoutReplayViewer();
+}
+#pragma endregion
+#pragma region MainMenu
+void LayoutMainMenu()
+{
+    mainMenuData.pos.x = screenWidth * .35;
+    mainMenuData.pos.y = screenHeight * .35;
+    mainMenuData.fontScale = screenHeight * .05 ;
+    mainMenuData.spaccing = mainMenuData.fontScale + (mainMenuData.fontScale * .5);
+    mainMenuData.fontColor = BLACK;
+    
+    mainMenuData.reactionRect.x = mainMenuData.pos.x;
+    mainMenuData.reactionRect.y = mainMenuData.pos.y;
+    mainMenuData.reactionRect.width =  MeasureText("Reaction Practice", mainMenuData.fontScale);
+    mainMenuData.reactionRect.height = mainMenuData.fontScale;
+
+    mainMenuData.trackingRect.x = mainMenuData.pos.x;
+    mainMenuData.trackingRect.y = mainMenuData.pos.y + mainMenuData.spaccing;
+    mainMenuData.trackingRect.width = MeasureText("Tracking Practice", mainMenuData.fontScale);
+    mainMenuData.trackingRect.height = mainMenuData.fontScale;
+}
+void DrawMainMenu()
+{
+    
+    //DrawRectangleRec(mainMenuData.reactionRect, RED);
+    //DrawRectangleRec(mainMenuData.trackingRect, BLUE);
+    DrawUiText("Reaction Practice",mainMenuData.pos.x,mainMenuData.pos.y,mainMenuData.fontScale,mainMenuData.fontColor);
+    //DrawText("Tracking Practice",mainMenuData.trackingRect.x,mainMenuData.trackingRect.y,mainMenuData.fontScale,mainMenuData.fontColor);
+    
+    if (GuiLabelButton(mainMenuData.reactionRect, ""))
+    {
+        game.appState = REACTION;
+    }
+    // if (GuiLabelButton(mainMenuData.trackingRect, ""))
+    // {
+
+    // }
+    
+}
+#pragma endregion
+#pragma region  Reaction Game
+void UpdateReactionGameState()
+{
+    switch (reactionGame.gameState)
+    {
+    case START:
+        UpdateReactionStartMenu();
+        DrawReactionStartMenu();
+        break;
+    case PLAY:
+        UpdateReactionGame();
+        DrawReactionGame();
+        break;
+    case HIDE:
+        break;
+    case END:
+        UpdateReactionGameEnd();
+        DrawReactionGameEnd();
+        break;
+    
+    default:
+        break;
+    }
+    ReactionGameCheckForHide();
+}
+void ReactionGameCheckForHide()
+{
+    if(IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))
+    {
+        if(reactionGame.hideGame)
+        {
+            reactionGame.hideGame = false;
+            reactionGame.gameState = reactionGame.previousState;
+            if(reactionGame.gameState == PLAY)
+                DisableCursor();
+        }
+        else
+        {
+            reactionGame.hideGame = true;
+            reactionGame.previousState = reactionGame.gameState;
+            reactionGame.gameState = HIDE;   
+            EnableCursor(); 
+        }
+    }
+}
+void ResetReactionGame()
+{
+    InitReactionRound(&reactionGame, (unsigned int)GetRandomValue(1, INT_MAX));
+    BeginAimSession();
+    LogRoundEvent(EVENT_ROUND_START);
+}
+void InitReactionRound(ReactionGame *game, unsigned int seed)
+{
+    for(int i=0;i<NUM_REACTION_BALLS;++i){
+        game->balls[i] = false;
+        game->ballPositions[i] = (Vector3){0,0,700};
+    }
+    for (int i = 0; i < NUM_BALLS_ON_SCREEN; ++i)
+    {
+        game->activeBallIndexs[i] = 0;
+    }
+    
+    game->score = 1;
+    game->numClicks = 1;
+    game->hitCount = 1;
+    memset(game->partHits, 0, sizeof(game->partHits));
+    game->accuracy = 0;
+    game->timer = REACTION_ROUND_SECONDS;
+    game->seed = seed;
+    game->random = seed;
+    game->targetCount = REACTION_TARGETS;
+    game->startBallSize = game->ballSize;
+    game->adaptive = (AdaptiveDifficulty){ .spacing = game->rules.ballSpacing };
+    memset(game->motionFields, 0, sizeof(game->motionFields));
+    memset(game->motionRandom, 0, sizeof(game->motionRandom));
+    game->motionTime = 0.0f;
+    PickRandomStartBalls(game);
+}
+#pragma region  Raction game Start Menu
+void LayoutReactionStartMenu()
+{
+    reactionStart.pos.x = screenWidth * .35;
+    reactionStart.pos.y = screenHeight * .2;
+    reactionStart.fontScale = screenHeight * .05 ;
+    reactionStart.spaccing = screenHeight * 0.1;
+    float x = reactionStart.pos.x;
+    float y = reactionStart.pos.y;
+    int fontSize = reactionStart.fontScale;
+    Vector2 buttonSize = { screenWidth * .1, screenHeight * .1 };
+    //mouse sensitivity slider
+    reactionStart.sensitivityTextPos = (Vector2){ x, y };
+    y+=screenHeight *.05;
+    reactionStart.sensitivitySlider = (Rectangle){ x, y, screenWidth * .4, screenHeight *.05 };
+    // balls size buttons
+    y+=reactionStart.spaccing;
+    reactionStart.ballSizeTextPos = (Vector2){ x, y };
+    reactionStart.ballSizeMinus = (Rectangle){ x, y + fontSize, buttonSize.x, buttonSize.y };
+    reactionStart.ballSizePlus = (Rectangle){ x + buttonSize.x, y + fontSize, buttonSize.x, buttonSize.y };
+    //ball color buttons
+    y+=reactionStart.spaccing +10;
+    reactionStart.ballColorTextPos = (Vector2){ x, y };
+    reactionStart.ballColorSwatch = (Rectangle){ x + MeasureText("Ball Color: ",fontSize), y, fontSize, fontSize };
+    reactionStart.ballColorMinus = (Rectangle){ x, y + fontSize, buttonSize.x, buttonSize.y };
+    reactionStart.ballColorPlus = (Rectangle){ x + buttonSize.x, y + fontSize, buttonSize.x, buttonSize.y };
+    //target motion buttons
+    y+=reactionStart.spaccing +10;
+    reactionStart.motionTextPos = (Vector2){ x, y };
+    reactionStart.motionMinus = (Rectangle){ x, y + fontSize, buttonSize.x, buttonSize.y };
+    reactionStart.motionPlus = (Rectangle){ x + buttonSize.x, y + fontSize, buttonSize.x, buttonSize.y };
+    //background compression toggle
+    y+=reactionStart.spaccing + fontSize;
+    reactionStart.compressCheckBox = (Rectangle){ x, y, fontSize, fontSize };
+    reactionStart.compressTextPos = (Vector2){ x + fontSize*1.5f, y };
+    y+=fontSize*1.5f;
+    reactionStart.adaptiveCheckBox = (Rectangle){ x, y, fontSize, fontSize };
+    reactionStart.adaptiveTextPos = (Vector2){ x + fontSize*1.5f, y };
+    y+=fontSize*1.5f;
+    reactionStart.humanoidCheckBox = (Rectangle){ x, y, fontSize, fontSize };
+    reactionStart.humanoidTextPos = (Vector2){ x + fontSize*1.5f, y };
+    // space to start text
+    reactionStart.startTextPos = (Vector2){ x, screenHeight*.9 };
+}
+void UpdateReactionStartMenu()
+{
+    if (IsKeyPressed(KEY_SPACE))
+    {
+        reactionGame.gameState = PLAY;
+        SaveProfile();
+        //TODO: move this to reaction game start of play
+        DisableCursor();
+        reactionGame.ballColor = ballColors[reactionStart.ballColorIndex];
+        // only the round plays scaled up, the menu and the profile keep the size that was picked
+        reactionGame.ballSize = reactionStart.ballSize*4;
+        ResetReactionGame();
+    }
+}
+void DrawReactionStartMenu()
+{
+    int fontSize = reactionStart.fontScale;
+    Color textColor = mainMenuData.fontColor;
+    //mouse sensitivity buttons
+    DrawUiText(TextFormat("Mouse Sensitivity: %f",reactionStart.mouseSensitivity),reactionStart.sensitivityTextPos.x,reactionStart.sensitivityTextPos.y,fontSize,textColor);
+    GuiSliderBar(reactionStart.sensitivitySlider, "","", &reactionStart.mouseSensitivity, 0.0f, 10.0f);
+    // balls size buttons
+    DrawUiText(TextFormat("Ball Size: %d",(int)reactionStart.ballSize),reactionStart.ballSizeTextPos.x,reactionStart.ballSizeTextPos.y,fontSize,textColor);
+    DrawUiText("-",reactionStart.ballSizeMinus.x,reactionStart.ballSizeMinus.y,fontSize,textColor);
+    if (GuiLabelButton(reactionStart.ballSizeMinus, ""))
+    {
+        reactionStart.ballSize -= 1;
+        if(reactionStart.ballSize <=1)
+            reactionStart.ballSize = 1;
+    }
+    DrawUiText("+",reactionStart.ballSizePlus.x,reactionStart.ballSizePlus.y,fontSize,textColor);
+    if (GuiLabelButton(reactionStart.ballSizePlus, ""))
+    {
+        reactionStart.ballSize += 1;
+        if(reactionStart.ballSize >=10)
+            reactionStart.ballSize = 10;
+    }
+    //ball color buttons
+    DrawUiText("Ball Color: ", reactionStart.ballColorTextPos.x,reactionStart.ballColorTextPos.y,fontSize,textColor);
+    DrawRectangleRec(reactionStart.ballColorSwatch,ballColors[reactionStart.ballColorIndex]);
+    DrawUiText("-",reactionStart.ballColorMinus.x,reactionStart.ballColorMinus.y,fontSize,textColor);
+    if (GuiLabelButton(reactionStart.ballColorMinus, ""))
+    {
+        reactionStart.ballColorIndex -= 1;
+        if(reactionStart.ballColorIndex <=0)
+            reactionStart.ballColorIndex = numBallColors-1;
+    }
+    DrawUiText("+",reactionStart.ballColorPlus.x,reactionStart.ballColorPlus.y,fontSize,textColor);
+    if (GuiLabelButton(reactionStart.ballColorPlus, ""))
+    {
+        reactionStart.ballColorIndex += 1;
+        if(reactionStart.ballColorIndex >=numBallColors)
+            reactionStart.ballColorIndex = 0;
+    }
+    //target motion buttons
+    static const char *motionNames[MOTION_PATTERN_COUNT] = { "Still", "Strafe", "Bob", "Random Walk", "Bursts", "Mixed" };
+    DrawUiText(TextFormat("Targets: %s",motionNames[reactionGame.rules.motion]),reactionStart.motionTextPos.x,reactionStart.motionTextPos.y,fontSize,textColor);
+    DrawUiText("-",reactionStart.motionMinus.x,reactionStart.motionMinus.y,fontSize,textColor);
+    if (GuiLabelButton(reactionStart.motionMinus, ""))
+        reactionGame.rules.motion = (reactionGame.rules.motion + MOTION_PATTERN_COUNT - 1) % MOTION_PATTERN_COUNT;
+    DrawUiText("+",reactionStart.motionPlus.x,reactionStart.motionPlus.y,fontSize,textColor);
+    if (GuiLabelButton(reactionStart.motionPlus, ""))
+        reactionGame.rules.motion = (reactionGame.rules.motion + 1) % MOTION_PATTERN_COUNT;
+    //background compression toggle
+    bool compress = bgCompress.enabled;
+    GuiCheckBox(reactionStart.compressCheckBox, "", &compress);
+    DrawUiText("Compress Background", reactionStart.compressTextPos.x, reactionStart.compressTextPos.y, fontSize, textColor);
+    if (compress != bgCompress.enabled) SetBackgroundCompression(compress);
+    //adaptive difficulty toggle
+    bool adaptive = reactionGame.rules.adaptive;
+    GuiCheckBox(reactionStart.adaptiveCheckBox, "", &adaptive);
+    DrawUiText("Adaptive Difficulty", reactionStart.adaptiveTextPos.x, reactionStart.adaptiveTextPos.y, fontSize, textColor);
+    reactionGame.rules.adaptive = adaptive;
+    //humanoid targets toggle
+    bool humanoid = reactionGame.rules.humanoid;
+    GuiCheckBox(reactionStart.humanoidCheckBox, "", &humanoid);
+    DrawUiText("Humanoid Targets", reactionStart.humanoidTextPos.x, reactionStart.humanoidTextPos.y, fontSize, textColor);
+    reactionGame.rules.humanoid = humanoid;
+    
+    // space to start text
+    DrawUiText("Press SPACE to start",reactionStart.startTextPos.x,reactionStart.startTextPos.y,reactionStart.fontScale,mainMenuData.fontColor);
+    
+}
+#pragma endregion
+#pragma region Reaction Game Main Update
+void PickRandomStartBalls(ReactionGame *game)
+{
+    for (int i = 0; i < game->targetCount; i++) {
+        SpawnReactionTarget(game, i);
+    }   
+}
+int GetRandomBall(ReactionGame *game)
+{
+    // the round owns its generator so a recorded session picks the same balls when replayed
+    int newNum;
+    do {
+        newNum = NextRandom(&game->random) % NUM_REACTION_BALLS;
+    } while (IsInActiveArray(game, newNum)); // Ensure uniqueness
+    return newNum;
+}
+bool IsInActiveArray(const ReactionGame *game, int value){
+    for(int i=0;i<game->targetCount;i++){
+        if(game->activeBallIndexs[i] == value)
+            return true;
+    }
+    return false;
+}
+void UpdateReactionGame()
+{
+    ReactionInput input = { .dt = dt, .mouseDelta = GetMouseDelta(), .buttons = IsMouseButtonPressed(MOUSE_BUTTON_LEFT) ? REACTION_INPUT_CLICK : 0 };
+    int targetCount = reactionGame.targetCount;
+    unsigned int restart = 0;
+    RecordReactionInput(input);
+    StepReactionGame(&reactionGame, &camSettings, &camera, reactionStart.mouseSensitivity, input);
+    UpdateAimSession();
+    if (input.buttons & REACTION_INPUT_CLICK)
+    {
+        unsigned char parts[NUM_BALLS_ON_SCREEN];
+        int hits = FindReactionHits(&reactionGame, &camera, parts);
+        // the ID buffer answers frames later and is only checked against the rays, scoring stays analytic so sessions replay the same
+        RequestGpuPick(&reactionGame, &camera);
+        for (int i = 0; i < reactionGame.targetCount; ++i)
+            if (hits & (1 << i)) RecordAimClick(i, true);
+        // a miss is scored against the target the player was closest to, its next attempt starts from here
+        restart = hits;
+        if (hits == 0)
+        {
+            int nearest = FindNearestAimTarget();
+            RecordAimClick(nearest, false);
+            restart = 1u << nearest;
+        }
+        // events are only logged out here, re-simulated rounds never write them
+        LogClickEvents(hits, parts);
+        ApplyReactionClick(&reactionGame, hits, parts);
+        // hit targets respawned, an adaptive round may also have put up another one
+        unsigned int added = 0;
+        for (int i = targetCount; i < reactionGame.targetCount; i++) added |= 1u << i;
+        restart |= added;
+        LogSpawnEvents(hits | added);
+    }
+    if (restart != 0) RestartAimTrackers(restart);
+    if (reactionGame.gameState == END)
+    {
+        EnableCursor();
+        LogRoundEvent(EVENT_ROUND_END);
+        EndAimSession();
+        reactionGame.ballSize = reactionStart.ballSize;
+    }
+}
+void StepReactionGame(ReactionGame *game, CameraSettings *cam, Camera *view, float sensitivity, ReactionInput input)
+{
+    // no raylib state in here, the session re-simulation runs it on worker threads
+    game->timer -= input.dt;
+    if(game->timer<=0)
+    {
+        game->gameState=END;
+    }
+    if (game->rules.motion != MOTION_STATIC)
+    {
+        TargetMotion motion = GetReactionMotion(game);
+        for (game->motionTime += input.dt; game->motionTime >= MOTION_TICK; game->motionTime -= MOTION_TICK) StepTargetMotion(&motion);
+    }
+    //CAMERA UPDATE
+    // Get mouse movement
+    Vector2 mouseDelta = input.mouseDelta;
+    cam->yaw -= mouseDelta.x * sensitivity * cam->sensitivity;; // Rotate left/right
+    cam->pitch -= mouseDelta.y * sensitivity * cam->sensitivity;; // Rotate up/down
+    //camSettings.yaw -= mouseDelta.x * camSettings.sensitivity; // Rotate left/right
+    //camSettings.pitch -= mouseDelta.y * camSettings.sensitivity; // Rotate up/down
+
+    // Clamp pitch so the camera doesn't look too far up/down
+    cam->pitch = Clamp(cam->pitch, -cam->pitchLimit, cam->pitchLimit);
+
+    cam->yaw = Clamp(cam->yaw,-cam->yawLimit,cam->yawLimit);
+
+    // Calculate new camera target
+    Vector3 forward = {
+        cosf(cam->pitch) * sinf(cam->yaw), // X-axis rotation
+        sinf(cam->pitch),             // Y-axis rotation
+        cosf(cam->pitch) * cosf(cam->yaw)  // Z-axis rotation
+    };
+
+    // Set the camera target relative to position
+    view->target = (Vector3){
+        view->position.x + forward.x,
+        view->position.y + forward.y,
+        view->position.z + forward.z
+    };
+    //Calculate ball positions
+    game->ballOffset = game->rules.adaptive ? game->adaptive.spacing : game->rules.ballSpacing;//reactionGame.ballSize * 5;
+    float increment = (game->ballSize/2) + game->ballOffset;
+    float startX = (game->ballSize/2) + game->ballOffset *2 + game->ballSize*2;
+    float startY = (game->ballSize/2) + game->ballOffset * 2 + game->ballSize * 2;
+    startY = -startY;
+    int counter = 0;
+    
+    float y = startY;
+    for(int i =0; i <NUM_BALL_COLS;++i){
+        float x = startX;
+        for(int j =0;j<NUM_BALL_ROWS;++j){
+            game->ballPositions[counter].x = x;
+            game->ballPositions[counter].y = y;
+            game->ballPositions[counter].z = 700;
+            ++counter;
+            x -= increment;
+        }
+        y+=increment;            
+    }
+}
+int FindReactionHits(const ReactionGame *game, const Camera *view, unsigned char *parts)
+{
+    // the crosshair sits at the screen center, its ray is the view direction
+    Ray ray = { view->position, Vector3Normalize(Vector3Subtract(view->target, view->position)) };
+    int hits = 0;
+    for(int i =0; i <game->targetCount;++i){
+        if (game->rules.humanoid)
+        {
+            int part = RaycastHumanoid(ray, GetReactionTarget(game, i), game->ballSize*HUMANOID_SCALE, game->rules.hitPadding);
+            if (part < 0) continue;
+            hits |= 1 << i;
+            parts[i] = part;
+            continue;
+        }
+        RayCollision col = GetRayCollisionSphere(ray, GetReactionTarget(game, i),game->ballSize+game->rules.hitPadding);
+        if(col.hit) hits |= 1 << i;
+    }
+    return hits;
+}
+void ApplyReactionClick(ReactionGame *game, int hits, const unsigned char *parts)
+{
+    static const int partScores[HITBOX_PART_COUNT] = { 3, 2, 1 }; // hitScore multiplier per humanoid part
+    game->numClicks++;
+    float now = REACTION_ROUND_SECONDS - game->timer;
+    if (hits == 0) PushRollingStats(&game->adaptive.stats, false, 0.0f);
+    for(int i =0; i <game->targetCount;++i){
+        if(hits & (1 << i))
+        {
+            //TODO: update scores when ball hit
+            SpawnReactionTarget(game, i);
+            game->hitCount++;
+            if (game->rules.humanoid)
+            {
+                game->score += game->rules.hitScore*partScores[parts[i]];
+                game->partHits[parts[i]]++;
+            }
+            else game->score += game->rules.hitScore;
+            PushRollingStats(&game->adaptive.stats, true, now - game->adaptive.clearTime);
+        }
+    }
+    if (hits != 0) game->adaptive.clearTime = now;
+    game->accuracy = (float)game->hitCount / (float)game->numClicks;
+    if (game->rules.adaptive) UpdateAdaptiveDifficulty(game);
+}
+void DrawReactionGame()
+{
+    BeginSceneLayer();
+    BeginMode3D(camera);
+    float targetX[NUM_BALLS_ON_SCREEN], targetY[NUM_BALLS_ON_SCREEN], targetZ[NUM_BALLS_ON_SCREEN];
+    for(int i =0;i<reactionGame.targetCount;++i){
+        Vector3 p = GetReactionTarget(&reactionGame, i);
+        targetX[i] = p.x;
+        targetY[i] = p.y;
+        targetZ[i] = p.z;
+    }
+    if (reactionGame.rules.humanoid)
+        DrawTargetHumanoids(targetX, targetY, targetZ, culling.drillLod, reactionGame.targetCount, reactionGame.ballSize*HUMANOID_SCALE, reactionGame.ballColor);
+    else
+        DrawTargetSpheres(targetX, targetY, targetZ, culling.drillLod, reactionGame.targetCount, reactionGame.ballSize, reactionGame.ballColor);
+    DrawBenchTargets();
+    Vector3 pos = {0,0,100};
+    Vector3 size = {200,100,300};
+    DrawCubeWiresV(pos,size,BLACK);
+    EndMode3D();
+    EndSceneLayer();
+    float x = screenWidth * .2;
+    float y = 10;
+    DrawUiText(TextFormat("Score: %d",reactionGame.score),x,y,20,BLACK);
+    x = x + 110;
+    DrawUiText(TextFormat("Accuracy: %f",reactionGame.accuracy),x,y,20,BLACK);
+    
+    x = x + 210;
+    DrawUiText(TextFormat("Time: %d",(int)reactionGame.timer),x,y,20,BLACK);
+    if (reactionGame.rules.adaptive)
+        DrawUiText(TextFormat("Size: %.1f  Spread: %d  Targets: %d",reactionGame.ballSize,reactionGame.ballOffset,reactionGame.targetCount),screenWidth * .2,y + 24,10,BLACK);
+    if (reactionGame.rules.humanoid)
+        DrawUiText(TextFormat("Head: %d  Body: %d  Limbs: %d",reactionGame.partHits[HITBOX_HEAD],reactionGame.partHits[HITBOX_BODY],reactionGame.partHits[HITBOX_LIMB]),screenWidth * .2,y + 36,10,BLACK);
+    
+    //crosshair
+    DrawUiText(TextFormat("+"),screenWidth/2,screenHeight/2-10,20,BLACK);
+}
+#pragma endregion
+#pragma region Reaction Game End
+void UpdateReactionGameEnd()
+{
+    if(IsKeyPressed(KEY_SPACE))
+    {
+        reactionGame.gameState = START;
+    }
+    // watch the round just played, with the one before it as the ghost
+    if (IsKeyPressed(KEY_R) && session.statsReady && session.savedPath[0] != '\0')
+        StartReplayViewer(session.savedPath, session.previousPath[0] != '\0' ? session.previousPath : NULL);
+}
+void DrawReactionGameEnd()
+{   
+    float x = reactionStart.pos.x;
+    float y = reactionStart.pos.y;
+    int fontSize = reactionStart.fontScale;
+    Color textColor = mainMenuData.fontColor;
+    //score
+    DrawUiText(TextFormat("Score: %d",reactionGame.score),x,y,fontSize,textColor);
+    //accuracy
+    y+=reactionStart.spaccing;
+    DrawUiText(TextFormat("Accuracy: %f",reactionGame.accuracy),x,y,fontSize,textColor);
+    //numhits
+    y+=reactionStart.spaccing;
+    //DrawText(TextFormat("Targets Hit: %d",reactionGame.Nu),x,y,fontSize,textColor);
+    if (reactionGame.rules.humanoid)
+        DrawUiText(TextFormat("Headshots: %d of %d hits", reactionGame.partHits[HITBOX_HEAD], reactionGame.hitCount - 1),x,y + fontSize*1.5f,fontSize/2,textColor);
+    //how the targets were acquired
+    if (session.statsReady && session.summaryCount > 0)
+    {
+        DrawUiText(TextFormat("Overshoot: %.1f deg  Corrections: %.1f", session.averageOvershoot, session.averageSubmovements),x,y,fontSize/2,textColor);
+        DrawUiText(TextFormat("First stop: %d ms  Path efficiency: %d%%", (int)(session.averageFirstStop*1000.0f), (int)(session.averageEfficiency*100.0f)),x,y + fontSize*0.75f,fontSize/2,textColor);
+    }
+
+    //press space text
+    y=screenHeight*.9;
+    DrawUiText("Press SPACE to restart",x,y,reactionStart.fontScale,mainMenuData.fontColor);
+    if (session.statsReady && session.savedPath[0] != '\0') DrawUiText("Press R to watch the replay",x,y + reactionStart.fontScale,reactionStart.fontScale/2,mainMenuData.fontColor);
+}
+#pragma endregion
+#pragma endregion
+#pragma region Adaptive Difficulty
+void PushRollingStats(RollingStats *stats, bool hit, float reaction)
+{
+    int slot = stats->head;
+    if (stats->count == ADAPTIVE_WINDOW)
+    {
+        // the oldest click falls out of the window
+        stats->hitCount -= stats->hits[slot];
+        if (stats->buckets[slot] < ADAPTIVE_BUCKETS) stats->histogram[stats->buckets[slot]]--;
+    }
+    else stats->count++;
+    int bucket = hit ? (int)Clamp(reaction/ADAPTIVE_BUCKET_SECONDS, 0.0f, ADAPTIVE_BUCKETS - 1) : ADAPTIVE_BUCKETS;
+    stats->hits[slot] = hit;
+    stats->buckets[slot] = bucket;
+    stats->hitCount += hit;
+    if (hit) stats->histogram[bucket]++;
+    stats->head = (slot + 1) % ADAPTIVE_WINDOW;
+}
+float GetRollingPercentile(const RollingStats *stats, float fraction)
+{
+    // walks the fixed bucket count, not the window, and answers with the bucket's upper edge
+    if (stats->hitCount == 0) return 0.0f;
+    int rank = (int)ceilf(fraction*stats->hitCount);
+    if (rank < 1) rank = 1;
+    int seen = 0;
+    for (int b = 0; b < ADAPTIVE_BUCKETS; b++)
+    {
+        seen += stats->histogram[b];
+        if (seen >= rank) return (b + 1)*ADAPTIVE_BUCKET_SECONDS;
+    }
+    return ADAPTIVE_BUCKETS*ADAPTIVE_BUCKET_SECONDS;
+}
+void UpdateAdaptiveDifficulty(ReactionGame *game)
+{
+    // runs inside the round's own step so replays and --resim land on the same targets
+    AdaptiveDifficulty *a = &game->adaptive;
+    a->settle++;
+    if (a->stats.count < ADAPTIVE_MIN_SAMPLES) return;
+
+    // each skill steers towards its own goal, so whichever is weaker gets easier targets and the stronger one keeps getting harder
+    float accuracyError = (float)a->stats.hitCount/a->stats.count - ADAPTIVE_HIT_RATE;
+    float speedError = Clamp((ADAPTIVE_REACTION - GetRollingPercentile(&a->stats, ADAPTIVE_PERCENTILE))/ADAPTIVE_REACTION, -1.0f, 1.0f);
+    // the grid step is half a size plus the spread, so neighbours only stay apart with 1.5 sizes and both paddings between them
+    float maxSize = Clamp((ADAPTIVE_MAX_SPACING - 2.0f*game->rules.hitPadding)/1.5f, ADAPTIVE_MIN_SIZE, ADAPTIVE_MAX_SIZE);
+    game->ballSize = Clamp(game->ballSize*(1.0f - ADAPTIVE_GAIN*accuracyError), ADAPTIVE_MIN_SIZE, maxSize);
+    float minSpacing = Clamp(ceilf(1.5f*game->ballSize + 2.0f*game->rules.hitPadding), ADAPTIVE_MIN_SPACING, ADAPTIVE_MAX_SPACING);
+    a->spacing = Clamp(a->spacing*(1.0f + ADAPTIVE_GAIN*speedError), minSpacing, ADAPTIVE_MAX_SPACING);
+
+    // once the spread runs out the target count takes over, fewer targets up means longer flicks between them
+    if (a->settle < ADAPTIVE_WINDOW/2) return;
+    if (speedError > 0.0f && a->spacing >= ADAPTIVE_MAX_SPACING && game->targetCount > 1)
+    {
+        game->targetCount--;
+        a->settle = 0;
+    }
+    else if (speedError < 0.0f && a->spacing <= minSpacing && game->targetCount < NUM_BALLS_ON_SCREEN)
+    {
+        SpawnReactionTarget(game, game->targetCount);
+        game->targetCount++;
+        a->settle = 0;
+    }
+}
+#pragma endregion
+#pragma region Target Motion
+unsigned int NextRandom(unsigned int *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+static float RandomRange(unsigned int *state, float low, float high)
+{
+    return low + (high - low)*(NextRandom(state) >> 8)*(1.0f/16777216.0f);
+}
+void SpawnTargetMotion(TargetMotion *motion, int lane, MotionPattern pattern, unsigned int *random)
+{
+    float *f = motion->fields + lane;
+    int stride = motion->capacity;
+    for (int i = 0; i < MOTION_FIELD_COUNT; i++) f[i*stride] = 0.0f;
+    f[MOTION_DAMPING*stride] = 1.0f;
+    f[MOTION_RANGE_X*stride] = MOTION_OFFSET_X;
+    f[MOTION_RANGE_Y*stride] = MOTION_OFFSET_Y;
+    f[MOTION_PERIOD*stride] = MOTION_NEVER;
+    f[MOTION_BURST_TIME*stride] = MOTION_NEVER;
+    motion->random[lane] = NextRandom(random) | 1;
+    if (pattern == MOTION_MIXED) pattern = MOTION_STRAFE + NextRandom(random) % (MOTION_MIXED - MOTION_STRAFE);
+    // the draws for one pattern never depend on another's, so a replay spawns the same targets
+    float side = (NextRandom(random) & 1) ? 1.0f : -1.0f;
+    switch (pattern)
+    {
+    case MOTION_STRAFE:
+        f[MOTION_VX*stride] = side*RandomRange(random, 40.0f, 120.0f);
+        break;
+    case MOTION_SINE:
+    {
+        // a spring back to the anchor swings as a sinusoid, amplitude is speed over angular frequency
+        float omega = 2.0f*PI*RandomRange(random, 0.5f, 1.5f);
+        f[MOTION_STIFFNESS*stride] = omega*omega;
+        f[MOTION_VY*stride] = side*RandomRange(random, 15.0f, 35.0f)*omega;
+        f[MOTION_VX*stride] = side*RandomRange(random, 0.0f, 30.0f);
+        break;
+    }
+    case MOTION_WALK:
+        f[MOTION_JITTER*stride] = RandomRange(random, 600.0f, 1200.0f);
+        f[MOTION_DAMPING*stride] = 0.99f;
+        break;
+    case MOTION_BURST:
+        f[MOTION_AX*stride] = side*RandomRange(random, 800.0f, 1500.0f);
+        f[MOTION_AY*stride] = RandomRange(random, -300.0f, 300.0f);
+        f[MOTION_PERIOD*stride] = RandomRange(random, 0.6f, 1.2f);
+        f[MOTION_BURST_TIME*stride] = 0.15f;
+        f[MOTION_DAMPING*stride] = 0.985f;
+        break;
+    default:
+        break;
+    }
+}
+void StepTargetMotion(TargetMotion *motion)
+{
+    // one fixed tick for every lane, all patterns are the same sum of terms with different parameters
+    int stride = motion->capacity;
+    float *x = motion->fields + MOTION_X*stride, *y = motion->fields + MOTION_Y*stride;
+    float *px = motion->fields + MOTION_PREV_X*stride, *py = motion->fields + MOTION_PREV_Y*stride;
+    float *vx = motion->fields + MOTION_VX*stride, *vy = motion->fields + MOTION_VY*stride;
+    float *ax = motion->fields + MOTION_AX*stride, *ay = motion->fields + MOTION_AY*stride;
+    float *stiffness = motion->fields + MOTION_STIFFNESS*stride, *damping = motion->fields + MOTION_DAMPING*stride;
+    float *jitter = motion->fields + MOTION_JITTER*stride;
+    float *rangeX = motion->fields + MOTION_RANGE_X*stride, *rangeY = motion->fields + MOTION_RANGE_Y*stride;
+    float *phase = motion->fields + MOTION_PHASE*stride, *period = motion->fields + MOTION_PERIOD*stride;
+    float *burst = motion->fields + MOTION_BURST_TIME*stride;
+    unsigned int *random = motion->random;
+    float tick = MOTION_TICK;
+    int i = 0;
+#if defined(__SSE2__)
+    // the scalar loop below does the same operations in the same order, both land on identical bits
+    __m128 tickv = _mm_set1_ps(tick);
+    __m128 zero = _mm_setzero_ps();
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 noiseScale = _mm_set1_ps(1.0f/2147483648.0f);
+    for (; i + 4 <= motion->count; i += 4)
+    {
+        __m128 xv = _mm_loadu_ps(x + i), yv = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(px + i, xv);
+        _mm_storeu_ps(py + i, yv);
+        __m128 per = _mm_loadu_ps(period + i);
+        __m128 ph = _mm_add_ps(_mm_loadu_ps(phase + i), tickv);
+        __m128 wrap = _mm_cmpge_ps(ph, per);
+        ph = _mm_sub_ps(ph, _mm_and_ps(wrap, per));
+        __m128 axv = _mm_xor_ps(_mm_loadu_ps(ax + i), _mm_and_ps(wrap, sign));
+        __m128 ayv = _mm_xor_ps(_mm_loadu_ps(ay + i), _mm_and_ps(wrap, sign));
+        _mm_storeu_ps(phase + i, ph);
+        _mm_storeu_ps(ax + i, axv);
+        _mm_storeu_ps(ay + i, ayv);
+        __m128 on = _mm_cmplt_ps(ph, _mm_loadu_ps(burst + i));
+
+        __m128i r = _mm_loadu_si128((const __m128i *)(random + i));
+        r = _mm_xor_si128(r, _mm_slli_epi32(r, 13));
+        r = _mm_xor_si128(r, _mm_srli_epi32(r, 17));
+        r = _mm_xor_si128(r, _mm_slli_epi32(r, 5));
+        __m128 nx = _mm_mul_ps(_mm_cvtepi32_ps(r), noiseScale);
+        r = _mm_xor_si128(r, _mm_slli_epi32(r, 13));
+        r = _mm_xor_si128(r, _mm_srli_epi32(r, 17));
+        r = _mm_xor_si128(r, _mm_slli_epi32(r, 5));
+        __m128 ny = _mm_mul_ps(_mm_cvtepi32_ps(r), noiseScale);
+        _mm_storeu_si128((__m128i *)(random + i), r);
+
+        __m128 k = _mm_loadu_ps(stiffness + i), j = _mm_loadu_ps(jitter + i), d = _mm_loadu_ps(damping + i);
+        __m128 fx = _mm_add_ps(_mm_sub_ps(_mm_and_ps(on, axv), _mm_mul_ps(k, xv)), _mm_mul_ps(j, nx));
+        __m128 fy = _mm_add_ps(_mm_sub_ps(_mm_and_ps(on, ayv), _mm_mul_ps(k, yv)), _mm_mul_ps(j, ny));
+        __m128 vxv = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(fx, tickv)), d);
+        __m128 vyv = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(fy, tickv)), d);
+        xv = _mm_add_ps(xv, _mm_mul_ps(vxv, tickv));
+        yv = _mm_add_ps(yv, _mm_mul_ps(vyv, tickv));
+
+        // bounce off the edges of the range
+        __m128 rx = _mm_loadu_ps(rangeX + i), ry = _mm_loadu_ps(rangeY + i);
+        __m128 outX = _mm_cmpgt_ps(_mm_andnot_ps(sign, xv), rx);
+        __m128 outY = _mm_cmpgt_ps(_mm_andnot_ps(sign, yv), ry);
+        vxv = _mm_xor_ps(vxv, _mm_and_ps(outX, sign));
+        vyv = _mm_xor_ps(vyv, _mm_and_ps(outY, sign));
+        xv = _mm_min_ps(_mm_max_ps(xv, _mm_sub_ps(zero, rx)), rx);
+        yv = _mm_min_ps(_mm_max_ps(yv, _mm_sub_ps(zero, ry)), ry);
+        _mm_storeu_ps(x + i, xv);
+        _mm_storeu_ps(y + i, yv);
+        _mm_storeu_ps(vx + i, vxv);
+        _mm_storeu_ps(vy + i, vyv);
+    }
+#endif
+    for (; i < motion->count; i++)
+    {
+        px[i] = x[i];
+        py[i] = y[i];
+        phase[i] += tick;
+        if (phase[i] >= period[i])
+        {
+            phase[i] -= period[i];
+            ax[i] = -ax[i];
+            ay[i] = -ay[i];
+        }
+        bool on = phase[i] < burst[i];
+        float nx = (float)(int)NextRandom(&random[i])*(1.0f/2147483648.0f);
+        float ny = (float)(int)NextRandom(&random[i])*(1.0f/2147483648.0f);
+        float fx = ((on ? ax[i] : 0.0f) - stiffness[i]*x[i]) + jitter[i]*nx;
+        float fy = ((on ? ay[i] : 0.0f) - stiffness[i]*y[i]) + jitter[i]*ny;
+        vx[i] = (vx[i] + fx*tick)*damping[i];
+        vy[i] = (vy[i] + fy*tick)*damping[i];
+        x[i] += vx[i]*tick;
+        y[i] += vy[i]*tick;
+        if (fabsf(x[i]) > rangeX[i]) vx[i] = -vx[i];
+        if (fabsf(y[i]) > rangeY[i]) vy[i] = -vy[i];
+        x[i] = fminf(fmaxf(x[i], 0.0f - rangeX[i]), rangeX[i]);
+        y[i] = fminf(fmaxf(y[i], 0.0f - rangeY[i]), rangeY[i]);
+    }
+}
+TargetMotion GetReactionMotion(ReactionGame *game)
+{
+    return (TargetMotion){ .fields = game->motionFields, .random = game->motionRandom, .capacity = MOTION_LANES, .count = MOTION_LANES };
+}
+void SpawnReactionTarget(ReactionGame *game, int slot)
+{
+    game->activeBallIndexs[slot] = GetRandomBall(game);
+    if (game->rules.motion == MOTION_STATIC) return;
+    TargetMotion motion = GetReactionMotion(game);
+    SpawnTargetMotion(&motion, slot, game->rules.motion, &game->random);
+}
+Vector3 GetReactionTarget(const ReactionGame *game, int slot)
+{
+    // between the last two ticks by how far the round is into the next one, the click tests exactly what was drawn this frame
+    Vector3 p = game->ballPositions[game->activeBallIndexs[slot]];
+    if (game->rules.motion == MOTION_STATIC) return p;
+    const float *f = game->motionFields + slot;
+    float t = game->motionTime/MOTION_TICK;
+    p.x += Lerp(f[MOTION_PREV_X*MOTION_LANES], f[MOTION_X*MOTION_LANES], t);
+    p.y += Lerp(f[MOTION_PREV_Y*MOTION_LANES], f[MOTION_Y*MOTION_LANES], t);
+    return p;
+}
+#pragma endregion
+#pragma region Humanoid Hitboxes
+static void GetHitboxShapeBounds(const HitboxShape *shape, Vector3 *min, Vector3 *max)
+{
+    if (shape->box)
+    {
+        *min = shape->a;
+        *max = shape->b;
+        return;
+    }
+    Vector3 r = { shape->radius, shape->radius, shape->radius };
+    *min = Vector3Subtract(Vector3Min(shape->a, shape->b), r);
+    *max = Vector3Add(Vector3Max(shape->a, shape->b), r);
+}
+static float GetHitboxShapeCenter(const HitboxShape *shape, int axis)
+{
+    return ((const float *)&shape->a)[axis] + ((const float *)&shape->b)[axis];
+}
+static void BuildHitboxNode(HumanoidHitbox *hb, int index, int first, int count)
+{
+    HitboxNode *node = &hb->nodes[index];
+    GetHitboxShapeBounds(&hb->shapes[first], &node->min, &node->max);
+    for (int i = first + 1; i < first + count; i++)
+    {
+        Vector3 min, max;
+        GetHitboxShapeBounds(&hb->shapes[i], &min, &max);
+        node->min = Vector3Min(node->min, min);
+        node->max = Vector3Max(node->max, max);
+    }
+    if (count <= 2)
+    {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+    // halves by centre along the longest side, a handful of shapes so an insertion sort will do
+    Vector3 extent = Vector3Subtract(node->max, node->min);
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    for (int i = first + 1; i < first + count; i++)
+    {
+        HitboxShape shape = hb->shapes[i];
+        int j = i;
+        for (; j > first && GetHitboxShapeCenter(&hb->shapes[j - 1], axis) > GetHitboxShapeCenter(&shape, axis); j--) hb->shapes[j] = hb->shapes[j - 1];
+        hb->shapes[j] = shape;
+    }
+    node->first = hb->nodeCount;
+    node->count = 0;
+    hb->nodeCount += 2;
+    BuildHitboxNode(hb, node->first, first, count/2);
+    BuildHitboxNode(hb, node->first + 1, first + count/2, count - count/2);
+}
+void InitHumanoidHitbox()
+{
+    // facing the camera down +z, the target position is the middle of the chest
+    HumanoidHitbox *hb = &humanoidHitbox;
+    static const HitboxShape shapes[HUMANOID_SHAPES] = {
+        { .a = { 0.0f, 1.35f, 0.0f }, .b = { 0.0f, 1.5f, 0.0f }, .radius = 0.3f, .box = false, .part = HITBOX_HEAD },
+        { .a = { -0.45f, -0.2f, -0.25f }, .b = { 0.45f, 1.1f, 0.25f }, .radius = 0.0f, .box = true, .part = HITBOX_BODY }, // chest
+        { .a = { -0.3f, -0.45f, -0.2f }, .b = { 0.3f, -0.15f, 0.2f }, .radius = 0.0f, .box = true, .part = HITBOX_BODY },  // hips
+        { .a = { -0.6f, 1.0f, 0.0f }, .b = { -0.7f, -0.05f, 0.0f }, .radius = 0.13f, .box = false, .part = HITBOX_LIMB },
+        { .a = { 0.6f, 1.0f, 0.0f }, .b = { 0.7f, -0.05f, 0.0f }, .radius = 0.13f, .box = false, .part = HITBOX_LIMB },
+        { .a = { -0.22f, -0.35f, 0.0f }, .b = { -0.26f, -1.75f, 0.0f }, .radius = 0.16f, .box = false, .part = HITBOX_LIMB },
+        { .a = { 0.22f, -0.35f, 0.0f }, .b = { 0.26f, -1.75f, 0.0f }, .radius = 0.16f, .box = false, .part = HITBOX_LIMB },
+    };
+    memcpy(hb->shapes, shapes, sizeof(shapes));
+    hb->nodeCount = 1;
+    BuildHitboxNode(hb, 0, 0, HUMANOID_SHAPES);
+    hb->boundRadius = 0.0f;
+    for (int i = 0; i < HUMANOID_SHAPES; i++)
+    {
+        Vector3 min, max;
+        GetHitboxShapeBounds(&hb->shapes[i], &min, &max);
+        Vector3 far = { fmaxf(fabsf(min.x), fabsf(max.x)), fmaxf(fabsf(min.y), fabsf(max.y)), fmaxf(fabsf(min.z), fabsf(max.z)) };
+        hb->boundRadius = fmaxf(hb->boundRadius, Vector3Length(far));
+    }
+}
+static float RaySphereDistance(Vector3 origin, Vector3 direction, Vector3 center, float radius)
+{
+    // distance along a normalized ray to the sphere, negative on a miss
+    Vector3 oc = Vector3Subtract(origin, center);
+    float b = Vector3DotProduct(oc, direction);
+    float c = Vector3DotProduct(oc, oc) - radius*radius;
+    float h = b*b - c;
+    if (h < 0.0f) return -1.0f;
+    h = sqrtf(h);
+    return -b - h >= 0.0f ? -b - h : -b + h;
+}
+static float RayBoxDistance(Vector3 origin, Vector3 inverse, Vector3 min, Vector3 max, float padding)
+{
+    float tx0 = (min.x - padding - origin.x)*inverse.x, tx1 = (max.x + padding - origin.x)*inverse.x;
+    float ty0 = (min.y - padding - origin.y)*inverse.y, ty1 = (max.y + padding - origin.y)*inverse.y;
+    float tz0 = (min.z - padding - origin.z)*inverse.z, tz1 = (max.z + padding - origin.z)*inverse.z;
+    float near = fmaxf(fmaxf(fminf(tx0, tx1), fminf(ty0, ty1)), fminf(tz0, tz1));
+    float far = fminf(fminf(fmaxf(tx0, tx1), fmaxf(ty0, ty1)), fmaxf(tz0, tz1));
+    if (far < near || far < 0.0f) return -1.0f;
+    return near > 0.0f ? near : 0.0f;
+}
+static float RayCapsuleDistance(Vector3 origin, Vector3 direction, Vector3 a, Vector3 b, float radius)
+{
+    // the side is an infinite cylinder clipped to the segment, the ends are spheres, the nearest of them wins
+    Vector3 ba = Vector3Subtract(b, a);
+    Vector3 oa = Vector3Subtract(origin, a);
+    float baba = Vector3DotProduct(ba, ba);
+    float bard = Vector3DotProduct(ba, direction);
+    float baoa = Vector3DotProduct(ba, oa);
+    float k2 = baba - bard*bard;
+    float k1 = baba*Vector3DotProduct(oa, direction) - baoa*bard;
+    float k0 = baba*Vector3DotProduct(oa, oa) - baoa*baoa - radius*radius*baba;
+    float h = k1*k1 - k2*k0;
+    if (k2 > 1e-6f && h >= 0.0f)
+    {
+        float t = (-k1 - sqrtf(h))/k2;
+        float y = baoa + t*bard;
+        if (t >= 0.0f && y > 0.0f && y < baba) return t;
+    }
+    float ta = RaySphereDistance(origin, direction, a, radius);
+    float tb = RaySphereDistance(origin, direction, b, radius);
+    if (ta < 0.0f) return tb;
+    if (tb < 0.0f) return ta;
+    return fminf(ta, tb);
+}
+static float RayHitboxShapeDistance(const HitboxShape *shape, Vector3 origin, Vector3 direction, Vector3 inverse, float padding)
+{
+    if (shape->box) return RayBoxDistance(origin, inverse, shape->a, shape->b, padding);
+    return RayCapsuleDistance(origin, direction, shape->a, shape->b, shape->radius + padding);
+}
+int RaycastHumanoid(Ray ray, Vector3 position, float scale, float padding)
+{
+    // the part the ray meets first, or HITBOX_LIMB when only the hit padding reached the humanoid, -1 on a miss
+    // padded boxes grow along their diagonals, the bounding sphere grows with them
+    const HumanoidHitbox *hb = &humanoidHitbox;
+    if (RaySphereDistance(ray.position, ray.direction, position, hb->boundRadius*scale + padding*1.7320508f) < 0.0f) return -1;
+
+    // distances along the ray come out in humanoid units, they are only compared with each other
+    Vector3 origin = Vector3Scale(Vector3Subtract(ray.position, position), 1.0f/scale);
+    Vector3 direction = ray.direction;
+    Vector3 inverse = { 1.0f/direction.x, 1.0f/direction.y, 1.0f/direction.z };
+    padding /= scale;
+    float best = MOTION_NEVER;
+    int part = -1;
+    bool grazed = false;
+    int stack[2*HUMANOID_SHAPES];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const HitboxNode *node = &hb->nodes[stack[--top]];
+        float enter = RayBoxDistance(origin, inverse, node->min, node->max, padding);
+        if (enter < 0.0f || (part >= 0 && enter > best)) continue;
+        if (node->count == 0)
+        {
+            stack[top++] = node->first;
+            stack[top++] = node->first + 1;
+            continue;
+        }
+        for (int i = node->first; i < node->first + node->count; i++)
+        {
+            // parts are judged on the real shapes, the padding only decides whether a near miss still counts
+            const HitboxShape *shape = &hb->shapes[i];
+            float t = RayHitboxShapeDistance(shape, origin, direction, inverse, 0.0f);
+            if (t >= 0.0f)
+            {
+                if (t < best)
+                {
+                    best = t;
+                    part = shape->part;
+                }
+            }
+            else if (!grazed && padding > 0.0f) grazed = RayHitboxShapeDistance(shape, origin, direction, inverse, padding) >= 0.0f;
+        }
+    }
+    if (part < 0 && grazed) part = HITBOX_LIMB;
+    return part;
+}
+static int RaycastHumanoidShapes(Ray ray, Vector3 position, float scale, float padding)
+{
+    // every shape, no bounding sphere and no tree, what --hitbox-bench checks RaycastHumanoid against
+    const HumanoidHitbox *hb = &humanoidHitbox;
+    Vector3 origin = Vector3Scale(Vector3Subtract(ray.position, position), 1.0f/scale);
+    Vector3 inverse = { 1.0f/ray.direction.x, 1.0f/ray.direction.y, 1.0f/ray.direction.z };
+    padding /= scale;
+    float best = MOTION_NEVER;
+    int part = -1;
+    bool grazed = false;
+    for (int i = 0; i < HUMANOID_SHAPES; i++)
+    {
+        float t = RayHitboxShapeDistance(&hb->shapes[i], origin, ray.direction, inverse, 0.0f);
+        if (t >= 0.0f && t < best)
+        {
+            best = t;
+            part = hb->shapes[i].part;
+        }
+        if (RayHitboxShapeDistance(&hb->shapes[i], origin, ray.direction, inverse, padding) >= 0.0f) grazed = true;
+    }
+    if (part < 0 && grazed) part = HITBOX_LIMB;
+    return part;
+}
+int RunHitboxBenchmark(int humanoids)
+{
+    // a crowd on the drill's wall, rays from the camera spread over it, every click tests the whole crowd
+    if (humanoids < 1) humanoids = 1;
+    unsigned int random = 0x9e3779b9u;
+    Vector3 *positions = malloc(humanoids*sizeof(Vector3));
+    for (int i = 0; i < humanoids; i++)
+        positions[i] = (Vector3){ RandomRange(&random, -250.0f, 250.0f), RandomRange(&random, -150.0f, 150.0f), 700.0f };
+    float scale = 4.0f*5.0f*HUMANOID_SCALE;
+    Ray *rays = malloc(HITBOX_BENCH_RAYS*sizeof(Ray));
+    for (int i = 0; i < HITBOX_BENCH_RAYS; i++)
+    {
+        Vector3 target = { RandomRange(&random, -280.0f, 280.0f), RandomRange(&random, -180.0f, 180.0f), 700.0f };
+        rays[i] = (Ray){ { 0.0f, 0.0f, 0.0f }, Vector3Normalize(target) };
+    }
+
+    int counts[HITBOX_PART_COUNT] = { 0 };
+    unsigned char *parts = malloc((size_t)HITBOX_BENCH_RAYS*humanoids);
+    double start = ClockSeconds();
+    for (int i = 0; i < HITBOX_BENCH_RAYS; i++)
+        for (int j = 0; j < humanoids; j++)
+        {
+            int part = RaycastHumanoid(rays[i], positions[j], scale, REACTION_HIT_PADDING);
+            parts[(size_t)i*humanoids + j] = part;
+            if (part >= 0) counts[part]++;
+        }
+    double bvhTime = ClockSeconds() - start;
+    int mismatches = 0;
+    start = ClockSeconds();
+    for (int i = 0; i < HITBOX_BENCH_RAYS; i++)
+        for (int j = 0; j < humanoids; j++)
+            mismatches += (unsigned char)RaycastHumanoidShapes(rays[i], positions[j], scale, REACTION_HIT_PADDING) != parts[(size_t)i*humanoids + j];
+    double bruteTime = ClockSeconds() - start;
+
+    printf("%d humanoids, %d clicks, %d nodes\n", humanoids, HITBOX_BENCH_RAYS, humanoidHitbox.nodeCount);
+    printf("per click  bvh %.2f us  every shape %.2f us\n", bvhTime/HITBOX_BENCH_RAYS*1e6, bruteTime/HITBOX_BENCH_RAYS*1e6);
+    printf("hits  head %d  body %d  limb %d  mismatches %d\n", counts[HITBOX_HEAD], counts[HITBOX_BODY], counts[HITBOX_LIMB], mismatches);
+    free(positions);
+    free(rays);
+    free(parts);
+    return mismatches == 0 ? 0 : 1;
+}
+#pragma endregion
+#pragma region Aim Analytics
+static Vector2 GetAimAngles()
+{
+    return (Vector2){ camSettings.yaw, camSettings.pitch };
+}
+static Vector2 GetTargetAngles(int slot)
+{
+    // same convention as the camera forward vector in UpdateReactionGame
+    Vector3 p = GetReactionTarget(&reactionGame, slot);
+    return (Vector2){ atan2f(p.x, p.z), atan2f(p.y, sqrtf(p.x*p.x + p.z*p.z)) };
+}
+void BeginAimSession()
+{
+    session.startTime = time(NULL);
+    session.time = 0.0f;
+    session.summaryCount = 0;
+    session.inputCount = 0;
+    session.camera = camSettings;
+    RestartAimTrackers((1u << NUM_BALLS_ON_SCREEN) - 1);
+}
+void RecordReactionInput(ReactionInput input)
+{
+    // 16 bytes a frame, a round at 1000 fps is under half a megabyte
+    if (session.inputCount == session.inputCapacity)
+    {
+        session.inputCapacity = session.inputCapacity > 0 ? session.inputCapacity*2 : 4096;
+        session.inputs = realloc(session.inputs, session.inputCapacity*sizeof(ReactionInput));
+    }
+    session.inputs[session.inputCount++] = input;
+}
+void RestartAimTrackers(unsigned int slots)
+{
+    // a bit per slot whose acquisition starts over, the targets still up keep tracking from where they started
+    for (int i = 0; i < reactionGame.targetCount; i++)
+        if (slots & (1u << i)) session.trackers[i] = (AimTracker){ .startTime = session.time, .start = GetAimAngles(), .last = GetAimAngles(),
+                                               .armed = true, .firstMove = -1.0f, .firstStop = -1.0f };
+}
+static void UpdateAimTracker(AimTracker *t, Vector2 aim, Vector2 target)
+{
+    float step = Vector2Distance(aim, t->last);
+    t->path += step;
+    t->last = aim;
+    if (dt <= 0.0f) return;
+    float elapsed = session.time - t->startTime;
+    t->speed = Lerp(t->speed, step/dt, AIM_SPEED_SMOOTHING);
+
+    // progress along the straight line to the target, anything past its length is overshoot
+    Vector2 axis = Vector2Subtract(target, t->start);
+    float length = Vector2Length(axis);
+    float axial = length > 0.0f ? Vector2DotProduct(Vector2Subtract(aim, t->start), axis)/length : 0.0f;
+    t->axialSpeed = Lerp(t->axialSpeed, (axial - t->axial)/dt, AIM_SPEED_SMOOTHING);
+    t->axial = axial;
+    if (axial > t->maxAxial) t->maxAxial = axial;
+    // zero crossings of the velocity along the approach are corrections back towards the target
+    int sign = t->axialSpeed > AIM_MOVE_SPEED ? 1 : (t->axialSpeed < -AIM_MOVE_SPEED ? -1 : 0);
+    if (sign != 0)
+    {
+        if (t->lastSign != 0 && sign != t->lastSign) t->reversals++;
+        t->lastSign = sign;
+    }
+
+    if (t->firstMove < 0.0f && t->speed > AIM_MOVE_SPEED) t->firstMove = elapsed;
+    else if (t->firstMove >= 0.0f && t->firstStop < 0.0f && t->speed < AIM_STOP_SPEED) t->firstStop = elapsed;
+
+    // speed peaks with hysteresis so mouse jitter doesn't count, each peak is one sub-movement
+    if (t->armed)
+    {
+        if (t->speed > t->peak) t->peak = t->speed;
+        if (t->peak > AIM_MOVE_SPEED && t->speed < t->peak*AIM_PEAK_DROP)
+        {
+            t->submovements++;
+            t->armed = false;
+            t->valley = t->speed;
+        }
+    }
+    else
+    {
+        if (t->speed < t->valley) t->valley = t->speed;
+        if (t->speed > fmaxf(t->valley/AIM_PEAK_DROP, AIM_MOVE_SPEED))
+        {
+            t->armed = true;
+            t->peak = t->speed;
+        }
+    }
+}
+void UpdateAimSession()
+{
+    // a few multiply adds per target per frame, nothing is stored until the click
+    session.time += dt;
+    Vector2 aim = GetAimAngles();
+    for (int i = 0; i < reactionGame.targetCount; i++) UpdateAimTracker(&session.trackers[i], aim, GetTargetAngles(i));
+}
+int FindNearestAimTarget()
+{
+    Vector2 aim = GetAimAngles();
+    int nearest = 0;
+    for (int i = 1; i < reactionGame.targetCount; i++)
+        if (Vector2Distance(aim, GetTargetAngles(i)) < Vector2Distance(aim, GetTargetAngles(nearest))) nearest = i;
+    return nearest;
+}
+void RecordAimClick(int slot, bool hit)
+{
+    AimTracker *t = &session.trackers[slot];
+    Vector2 aim = GetAimAngles();
+    Vector2 target = GetTargetAngles(slot);
+    float distance = Vector2Distance(t->start, target);
+    float travelled = Vector2Distance(t->start, aim);
+    AimSummary summary = { 0 };
+    summary.time = session.time;
+    summary.reaction = t->firstMove;
+    summary.firstStop = t->firstStop;
+    summary.duration = session.time - t->startTime;
+    summary.distance = distance*RAD2DEG;
+    summary.overshoot = fmaxf(t->maxAxial - distance, 0.0f)*RAD2DEG;
+    summary.error = Vector2Distance(aim, target)*RAD2DEG;
+    summary.efficiency = t->path > 0.0f ? fminf(travelled/t->path, 1.0f) : 1.0f;
+    // a click mid flick ends the peak it was in
+    summary.submovements = t->submovements + (t->armed && t->peak > AIM_MOVE_SPEED);
+    summary.reversals = t->reversals;
+    summary.hit = hit;
+    if (session.summaryCount == session.summaryCapacity)
+    {
+        session.summaryCapacity = session.summaryCapacity > 0 ? session.summaryCapacity*2 : 64;
+        session.summaries = realloc(session.summaries, session.summaryCapacity*sizeof(AimSummary));
+    }
+    session.summaries[session.summaryCount++] = summary;
+}
+static void FinishAimSession(void *data)
+{
+    // on a worker, the job owns copies of the round so the next one can start straight away
+    AimSessionJob *job = data;
+    float overshoot = 0.0f, submovements = 0.0f, firstStop = 0.0f, efficiency = 0.0f;
+    int stops = 0;
+    for (int i = 0; i < job->header.summaryCount; i++)
+    {
+        AimSummary *summary = &job->summaries[i];
+        overshoot += summary->overshoot;
+        submovements += summary->submovements;
+        efficiency += summary->efficiency;
+        if (summary->firstStop >= 0.0f)
+        {
+            firstStop += summary->firstStop;
+            stops++;
+        }
+    }
+    int count = job->header.summaryCount > 0 ? job->header.summaryCount : 1;
+    job->averageOvershoot = overshoot/count;
+    job->averageSubmovements = submovements/count;
+    job->averageEfficiency = efficiency/count;
+    job->averageFirstStop = stops > 0 ? firstStop/stops : 0.0f;
+
+    char tmpPath[sizeof(job->path) + 8];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", job->path);
+    FILE *file = fopen(tmpPath, "wb");
+    bool ok = file != NULL && fwrite(&job->header, sizeof(job->header), 1, file) == 1 &&
+              fwrite(job->summaries, sizeof(AimSummary), job->header.summaryCount, file) == (size_t)job->header.summaryCount &&
+              fwrite(job->inputs, sizeof(ReactionInput), job->header.inputCount, file) == (size_t)job->header.inputCount;
+    if (file != NULL) ok = (fclose(file) == 0) && ok;
+    job->saved = ok && rename(tmpPath, job->path) == 0;
+    if (!job->saved) remove(tmpPath);
+}
+static void PublishAimSession(void *data)
+{
+    AimSessionJob *job = data;
+    session.averageOvershoot = job->averageOvershoot;
+    session.averageSubmovements = job->averageSubmovements;
+    session.averageFirstStop = job->averageFirstStop;
+    session.averageEfficiency = job->averageEfficiency;
+    session.statsReady = true;
+    if (job->saved)
+    {
+        TraceLog(LOG_INFO, "SESSION: [%s] Saved %d clicks", job->path, job->header.summaryCount);
+        memcpy(session.previousPath, session.savedPath, sizeof(session.savedPath));
+        snprintf(session.savedPath, sizeof(session.savedPath), "%s", job->path);
+    }
+    else TraceLog(LOG_WARNING, "SESSION: [%s] Failed to write session", job->path);
+    free(job->summaries);
+    free(job->inputs);
+    free(job);
+}
+void EndAimSession()
+{
+    // averages and the file are done on the job system, the end screen shows them once the job comes back
+    AimSessionJob *job = calloc(1, sizeof(AimSessionJob));
+    char directory[512];
+    char stamp[32];
+    time_t start = (time_t)session.startTime;
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&start));
+    snprintf(directory, sizeof(directory), "%s%s", GetApplicationDirectory(), SESSION_DIR);
+    snprintf(job->path, sizeof(job->path), "%s/%s.session", directory, stamp);
+    MakeDirectory(directory);
+
+    SessionHeader *header = &job->header;
+    header->magic = SESSION_MAGIC;
+    header->version = SESSION_VERSION;
+    header->headerSize = sizeof(SessionHeader);
+    header->summarySize = sizeof(AimSummary);
+    header->inputSize = sizeof(ReactionInput);
+    header->startTime = session.startTime;
+    header->duration = session.time;
+    header->ballSize = reactionGame.startBallSize;
+    header->mouseSensitivity = reactionStart.mouseSensitivity;
+    header->camera = session.camera;
+    header->rules = reactionGame.rules;
+    header->seed = reactionGame.seed;
+    header->score = reactionGame.score;
+    header->clicks = reactionGame.numClicks;
+    header->summaryCount = session.summaryCount;
+    header->inputCount = session.inputCount;
+    job->summaries = malloc((session.summaryCount + 1)*sizeof(AimSummary));
+    job->inputs = malloc((session.inputCount + 1)*sizeof(ReactionInput));
+    if (session.summaryCount > 0) memcpy(job->summaries, session.summaries, session.summaryCount*sizeof(AimSummary));
+    if (session.inputCount > 0) memcpy(job->inputs, session.inputs, session.inputCount*sizeof(ReactionInput));
+    session.statsReady = false;
+    SubmitJob(FinishAimSession, PublishAimSession, job);
+}
+#pragma endregion
+#pragma region Event Log
+unsigned int ChecksumEvents(const ReactionEvent *events, int count)
+{
+    // fnv-1a, it only has to catch a batch the crash cut short
+    const unsigned char *bytes = (const unsigned char *)events;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < (size_t)count*sizeof(ReactionEvent); i++) hash = (hash ^ bytes[i])*16777619u;
+    return hash;
+}
+long long FindEventLogEnd(const unsigned char *data, long long size)
+{
+    // -1 if it isn't an event log this build can append to
+    const EventLogHeader *header = (const EventLogHeader *)data;
+    if (data == NULL || size < (long long)sizeof(EventLogHeader) || header->magic != EVENT_LOG_MAGIC || header->version != EVENT_LOG_VERSION ||
+        header->headerSize < sizeof(EventLogHeader) || header->eventSize != sizeof(ReactionEvent)) return -1;
+    long long end = header->headerSize;
+    long long last = -1;
+    while (end + (long long)sizeof(EventBatchHeader) <= size)
+    {
+        const EventBatchHeader *batch = (const EventBatchHeader *)(data + end);
+        long long next = end + (long long)sizeof(EventBatchHeader) + (long long)batch->count*sizeof(ReactionEvent);
+        if (batch->magic != EVENT_BATCH_MAGIC || batch->count == 0 || batch->count > EVENT_QUEUE_SIZE || next > size) break;
+        last = end;
+        end = next;
+    }
+    // each batch is fsynced before the next is written, so only the last one can hold garbage, the rest aren't read at startup
+    if (last >= 0)
+    {
+        const EventBatchHeader *batch = (const EventBatchHeader *)(data + last);
+        if (ChecksumEvents((const ReactionEvent *)(batch + 1), batch->count) != batch->checksum) end = last;
+    }
+    return end;
+}
+#if defined(HAVE_IO_URING)
+static void CloseEventRing(EventRing *ring)
+{
+    if (ring->sqes != NULL) munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqMap != NULL && ring->cqMap != ring->sqMap) munmap(ring->cqMap, ring->cqMapSize);
+    if (ring->sqMap != NULL) munmap(ring->sqMap, ring->sqMapSize);
+    if (ring->fd >= 0) close(ring->fd);
+    *ring = (EventRing){ .fd = -1 };
+}
+static bool SetupEventRing(EventRing *ring)
+{
+    // a write and its fsync per batch, 4 entries is plenty
+    struct io_uring_params params = { 0 };
+    *ring = (EventRing){ .fd = (int)syscall(__NR_io_uring_setup, 4, &params) };
+    if (ring->fd < 0) return false;
+    ring->sqMapSize = params.sq_off.array + params.sq_entries*sizeof(unsigned int);
+    ring->cqMapSize = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    ring->sqesSize = params.sq_entries*sizeof(struct io_uring_sqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && ring->cqMapSize > ring->sqMapSize) ring->sqMapSize = ring->cqMapSize;
+    void *sq = mmap(NULL, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->sqMap = sq != MAP_FAILED ? sq : NULL;
+    void *cq = single ? sq : mmap(NULL, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->cqMap = cq != MAP_FAILED ? cq : NULL;
+    void *sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    ring->sqes = sqes != MAP_FAILED ? sqes : NULL;
+    if (ring->sqMap == NULL || ring->cqMap == NULL || ring->sqes == NULL)
+    {
+        CloseEventRing(ring);
+        return false;
+    }
+    unsigned char *sqBase = ring->sqMap;
+    unsigned char *cqBase = ring->cqMap;
+    ring->sqTail = (unsigned int *)(sqBase + params.sq_off.tail);
+    ring->sqMask = (unsigned int *)(sqBase + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned int *)(sqBase + params.sq_off.array);
+    ring->cqHead = (unsigned int *)(cqBase + params.cq_off.head);
+    ring->cqTail = (unsigned int *)(cqBase + params.cq_off.tail);
+    ring->cqMask = (unsigned int *)(cqBase + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cqBase + params.cq_off.cqes);
+    return true;
+}
+static bool CommitEventBatchRing(EventRing *ring, int size)
+{
+    // the write and the fsync go in with one syscall, linked so the fsync only runs once the whole batch landed
+    unsigned int tail = *ring->sqTail;
+    unsigned int mask = *ring->sqMask;
+    struct io_uring_sqe *write = &ring->sqes[tail & mask];
+    struct io_uring_sqe *sync = &ring->sqes[(tail + 1) & mask];
+    memset(write, 0, sizeof(*write));
+    memset(sync, 0, sizeof(*sync));
+    write->opcode = IORING_OP_WRITE;
+    write->fd = eventLog.fd;
+    write->addr = (unsigned long long)(uintptr_t)eventLog.batch;
+    write->len = size;
+    write->off = eventLog.offset;
+    write->flags = IOSQE_IO_LINK;
+    write->user_data = 0;
+    sync->opcode = IORING_OP_FSYNC;
+    sync->fd = eventLog.fd;
+    sync->fsync_flags = IORING_FSYNC_DATASYNC;
+    sync->user_data = 1;
+    ring->sqArray[tail & mask] = tail & mask;
+    ring->sqArray[(tail + 1) & mask] = (tail + 1) & mask;
+    __atomic_store_n(ring->sqTail, tail + 2, __ATOMIC_RELEASE);
+
+    int results[2] = { 0 };
+    int submit = 2;
+    int reaped = 0;
+    while (true)
+    {
+        unsigned int head = *ring->cqHead;
+        for (; reaped < 2 && head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE); head++, reaped++)
+        {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+            results[cqe->user_data & 1] = cqe->res;
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+        if (reaped == 2) break;
+        long entered = syscall(__NR_io_uring_enter, ring->fd, submit, 2 - reaped, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (entered < 0 && errno != EINTR) return false;
+        if (entered > 0) submit -= (int)entered;
+    }
+    // a short or failed write cancels the fsync, the fallback rewrites the batch at the same offset
+    return results[0] == size && results[1] == 0;
+}
+#endif
+#if !defined(PLATFORM_WEB)
+static bool CommitEventBatchSync(int size)
+{
+    for (int done = 0; done < size;)
+    {
+        ssize_t count = pwrite(eventLog.fd, eventLog.batch + done, size - done, eventLog.offset + done);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        done += (int)count;
+    }
+#if defined(__APPLE__)
+    // fsync on macos stops at the drive's cache
+    return fcntl(eventLog.fd, F_FULLFSYNC) == 0;
+#else
+    return fdatasync(eventLog.fd) == 0;
+#endif
+}
+static void *EventWriterThread(void *arg)
+{
+    (void)arg;
+    EventBatchHeader *header = (EventBatchHeader *)eventLog.batch;
+    ReactionEvent *events = (ReactionEvent *)(header + 1);
+    while (true)
+    {
+        // quit is read first, everything queued before it was set still goes out below
+        bool quit = atomic_load(&eventLog.quit);
+        unsigned int tail = atomic_load_explicit(&eventLog.tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&eventLog.head, memory_order_acquire);
+        int count = (int)(head - tail);
+        if (count > 0)
+        {
+            // whatever came in since the last commit is one append and one fsync
+            for (int i = 0; i < count; i++) events[i] = eventLog.queue[(tail + i) & (EVENT_QUEUE_SIZE - 1)];
+            atomic_store_explicit(&eventLog.tail, head, memory_order_release);
+            *header = (EventBatchHeader){ .magic = EVENT_BATCH_MAGIC, .count = count, .checksum = ChecksumEvents(events, count) };
+            int size = sizeof(EventBatchHeader) + count*sizeof(ReactionEvent);
+            double start = ClockSeconds();
+            bool committed = false;
+#if defined(HAVE_IO_URING)
+            if (atomic_load(&eventLog.uring) && !(committed = CommitEventBatchRing(&eventLog.ring, size)))
+            {
+                TraceLog(LOG_WARNING, "EVENTS: io_uring commit failed, falling back to pwrite");
+                CloseEventRing(&eventLog.ring);
+                atomic_store(&eventLog.uring, false);
+            }
+#endif
+            if (!committed) committed = CommitEventBatchSync(size);
+            atomic_store(&eventLog.commitMicros, (int)((ClockSeconds() - start)*1e6));
+            if (committed)
+            {
+                eventLog.offset += size;
+                atomic_fetch_add(&eventLog.written, count);
+                atomic_fetch_add(&eventLog.commits, 1);
+            }
+            else
+            {
+                // the next batch goes over whatever part of this one made it
+                TraceLog(LOG_WARNING, "EVENTS: Failed to write %d events", count);
+                atomic_fetch_add(&eventLog.failed, count);
+            }
+        }
+        if (quit) return NULL;
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)(EVENT_FLUSH_SECONDS*1e9);
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&eventLog.lock);
+        if (!atomic_load(&eventLog.quit)) pthread_cond_timedwait(&eventLog.wake, &eventLog.lock, &deadline);
+        pthread_mutex_unlock(&eventLog.lock);
+    }
+}
+#endif
+void StartEventLog()
+{
+#if !defined(PLATFORM_WEB)
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", GetApplicationDirectory(), EVENT_LOG_FILE_NAME);
+    // a kill mid-commit leaves at most one torn batch at the end, cut it off so new batches follow the last whole one
+    MappedFile file = MapFile(path);
+    long long size = (long long)file.size;
+    long long end = FindEventLogEnd(file.data, size);
+    UnmapFile(&file);
+    if (end < 0 && size > 0)
+    {
+        char old[520];
+        snprintf(old, sizeof(old), "%s.old", path);
+        rename(path, old);
+        TraceLog(LOG_WARNING, "EVENTS: [%s] Not an event log this version can append to, moved to %s", path, old);
+    }
+    eventLog.fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (eventLog.fd < 0)
+    {
+        TraceLog(LOG_WARNING, "EVENTS: [%s] Failed to open event log", path);
+        return;
+    }
+    if (end < 0)
+    {
+        EventLogHeader header = { .magic = EVENT_LOG_MAGIC, .version = EVENT_LOG_VERSION, .headerSize = sizeof(EventLogHeader), .eventSize = sizeof(ReactionEvent) };
+        end = sizeof(header);
+        if (ftruncate(eventLog.fd, 0) != 0 || pwrite(eventLog.fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+        {
+            TraceLog(LOG_WARNING, "EVENTS: [%s] Failed to write event log header", path);
+            close(eventLog.fd);
+            return;
+        }
+    }
+    else if (end < size)
+    {
+        TraceLog(LOG_WARNING, "EVENTS: [%s] Dropped %lld bytes of a batch cut short", path, size - end);
+        if (ftruncate(eventLog.fd, end) != 0) TraceLog(LOG_WARNING, "EVENTS: [%s] Failed to truncate event log", path);
+    }
+    eventLog.offset = end;
+    eventLog.batch = malloc(sizeof(EventBatchHeader) + EVENT_QUEUE_SIZE*sizeof(ReactionEvent));
+    atomic_store(&eventLog.head, 0);
+    atomic_store(&eventLog.tail, 0);
+    atomic_store(&eventLog.quit, false);
+#if defined(HAVE_IO_URING)
+    // kernels without io_uring, or with it turned off, get the pwrite path
+    atomic_store(&eventLog.uring, SetupEventRing(&eventLog.ring));
+#endif
+    pthread_mutex_init(&eventLog.lock, NULL);
+    pthread_cond_init(&eventLog.wake, NULL);
+    if (pthread_create(&eventLog.thread, NULL, EventWriterThread, NULL) != 0)
+    {
+        TraceLog(LOG_WARNING, "EVENTS: Failed to start the writer thread, events aren't saved");
+#if defined(HAVE_IO_URING)
+        if (atomic_load(&eventLog.uring)) CloseEventRing(&eventLog.ring);
+#endif
+        pthread_mutex_destroy(&eventLog.lock);
+        pthread_cond_destroy(&eventLog.wake);
+        free(eventLog.batch);
+        close(eventLog.fd);
+        return;
+    }
+    eventLog.running = true;
+    TraceLog(LOG_INFO, "EVENTS: [%s] Appending at %lld bytes with %s", path, end, atomic_load(&eventLog.uring) ? "io_uring" : "pwrite");
+#endif
+}
+void StopEventLog()
+{
+#if !defined(PLATFORM_WEB)
+    if (!eventLog.running) return;
+    // the writer drains the queue and commits once more before it exits
+    eventLog.running = false;
+    pthread_mutex_lock(&eventLog.lock);
+    atomic_store(&eventLog.quit, true);
+    pthread_cond_signal(&eventLog.wake);
+    pthread_mutex_unlock(&eventLog.lock);
+    pthread_join(eventLog.thread, NULL);
+#if defined(HAVE_IO_URING)
+    if (atomic_load(&eventLog.uring)) CloseEventRing(&eventLog.ring);
+#endif
+    pthread_mutex_destroy(&eventLog.lock);
+    pthread_cond_destroy(&eventLog.wake);
+    free(eventLog.batch);
+    eventLog.batch = NULL;
+    close(eventLog.fd);
+    TraceLog(LOG_INFO, "EVENTS: %u events saved in %u commits, %u dropped, %u failed", atomic_load(&eventLog.written),
+             atomic_load(&eventLog.commits), atomic_load(&eventLog.dropped), atomic_load(&eventLog.failed));
+#endif
+}
+void LogReactionEvent(ReactionEvent event)
+{
+    // the game thread never waits on the writer, a full queue drops the event and counts it
+    if (!eventLog.running) return;
+    unsigned int head = atomic_load_explicit(&eventLog.head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&eventLog.tail, memory_order_acquire) >= EVENT_QUEUE_SIZE)
+    {
+        atomic_fetch_add(&eventLog.dropped, 1);
+        return;
+    }
+    eventLog.queue[head & (EVENT_QUEUE_SIZE - 1)] = event;
+    atomic_store_explicit(&eventLog.head, head + 1, memory_order_release);
+}
+static ReactionEvent MakeReactionEvent(ReactionEventType type, int slot)
+{
+    ReactionEvent event = { .round = session.startTime, .time = REACTION_ROUND_SECONDS - reactionGame.timer, .type = type, .slot = slot,
+                            .humanoid = reactionGame.rules.humanoid, .yaw = camSettings.yaw, .pitch = camSettings.pitch,
+                            .size = reactionGame.ballSize, .value = reactionGame.numClicks };
+    if (slot < 0) return event;
+    event.position = GetReactionTarget(&reactionGame, slot);
+    event.reaction = event.time - eventLog.spawnTime[slot];
+    return event;
+}
+void LogRoundEvent(ReactionEventType type)
+{
+    ReactionEvent event = MakeReactionEvent(type, -1);
+    event.value = type == EVENT_ROUND_START ? (int)reactionGame.seed : reactionGame.score;
+    LogReactionEvent(event);
+    if (type != EVENT_ROUND_START) return;
+    for (int i = 0; i < reactionGame.targetCount; i++)
+    {
+        eventLog.spawnTime[i] = event.time;
+        ReactionEvent spawn = MakeReactionEvent(EVENT_SPAWN, i);
+        spawn.value = 0;
+        LogReactionEvent(spawn);
+    }
+}
+void LogClickEvents(int hits, const unsigned char *parts)
+{
+    // before the click is applied, while the hit targets are still where they were clicked
+    if (hits == 0)
+    {
+        LogReactionEvent(MakeReactionEvent(EVENT_MISS, FindNearestAimTarget()));
+        return;
+    }
+    for (int i = 0; i < reactionGame.targetCount; i++)
+    {
+        if (!(hits & (1 << i))) continue;
+        ReactionEvent event = MakeReactionEvent(EVENT_HIT, i);
+        if (reactionGame.rules.humanoid) event.part = parts[i];
+        LogReactionEvent(event);
+    }
+}
+void LogSpawnEvents(int hits)
+{
+    // after the click, the targets that were hit have respawned and any the click added are new
+    for (int i = 0; i < reactionGame.targetCount; i++)
+    {
+        if (!(hits & (1 << i))) continue;
+        eventLog.spawnTime[i] = REACTION_ROUND_SECONDS - reactionGame.timer;
+        ReactionEvent spawn = MakeReactionEvent(EVENT_SPAWN, i);
+        spawn.value = reactionGame.numClicks - 1;
+        LogReactionEvent(spawn);
+    }
+}
+void DrawEventLogStats()
+{
+    if (!renderStats.showOverlay) return;
+    if (!eventLog.running)
+    {
+        DrawUiText("events  not saved", 4, screenHeight - 98, 10, GRAY);
+        return;
+    }
+    DrawUiText(TextFormat("events  saved %u  commits %u  last commit %.1f ms with %s  queued %u  dropped %u", atomic_load(&eventLog.written),
+             atomic_load(&eventLog.commits), atomic_load(&eventLog.commitMicros)/1000.0f, atomic_load(&eventLog.uring) ? "io_uring" : "pwrite",
+             atomic_load(&eventLog.head) - atomic_load(&eventLog.tail), atomic_load(&eventLog.dropped) + atomic_load(&eventLog.failed)),
+             4, screenHeight - 98, 10, GRAY);
+}
+#pragma endregion
+#pragma region Event Export
+// parquet, so notebooks read it with pandas/pyarrow/duckdb as is. one data page per column per row group, no nulls
+enum{
+    EXPORT_PLAYER,
+    EXPORT_ROUND,
+    EXPORT_TIME,
+    EXPORT_EVENT,
+    EXPORT_SLOT,
+    EXPORT_PART,
+    EXPORT_HUMANOID,
+    EXPORT_YAW,
+    EXPORT_PITCH,
+    EXPORT_X,
+    EXPORT_Y,
+    EXPORT_Z,
+    EXPORT_SIZE,
+    EXPORT_REACTION,
+    EXPORT_VALUE,
+    EXPORT_COLUMN_COUNT
+};
+enum{ PARQUET_BOOLEAN = 0, PARQUET_INT32 = 1, PARQUET_INT64 = 2, PARQUET_FLOAT = 4, PARQUET_BYTE_ARRAY = 6 };
+enum{ PARQUET_PLAIN = 0, PARQUET_RLE = 3, PARQUET_BYTE_STREAM_SPLIT = 9 };
+enum{ PARQUET_UNCOMPRESSED = 0, PARQUET_GZIP = 2 };
+enum{ THRIFT_I32 = 5, THRIFT_I64 = 6, THRIFT_BINARY = 8, THRIFT_LIST = 9, THRIFT_STRUCT = 12 };
+typedef struct{
+    const char *name;
+    int type;
+    int converted;              // parquet ConvertedType, -1 for none
+}ExportColumn;
+static const ExportColumn exportColumns[EXPORT_COLUMN_COUNT] = {
+    { .name = "player", .type = PARQUET_BYTE_ARRAY, .converted = 0 }, // UTF8
+    { .name = "round", .type = PARQUET_INT64, .converted = 9 },      // TIMESTAMP_MILLIS
+    { .name = "time", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "event", .type = PARQUET_BYTE_ARRAY, .converted = 0 },
+    { .name = "slot", .type = PARQUET_INT32, .converted = -1 },
+    { .name = "part", .type = PARQUET_BYTE_ARRAY, .converted = 0 },
+    { .name = "humanoid", .type = PARQUET_BOOLEAN, .converted = -1 },
+    { .name = "yaw", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "pitch", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "x", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "y", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "z", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "size", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "reaction", .type = PARQUET_FLOAT, .converted = -1 },
+    { .name = "value", .type = PARQUET_INT32, .converted = -1 },
+};
+typedef struct{
+    long long offset;           // of the column's page header
+    int headerSize;
+    int rawSize;
+    int storedSize;
+    int codec;
+    int encoding;
+    unsigned char min[EXPORT_NAME_MAX];
+    unsigned char max[EXPORT_NAME_MAX];
+    int minSize;
+    int maxSize;
+}ExportChunk;
+typedef struct{
+    unsigned char *data;
+    int size;
+    int capacity;
+    short last[8];              // last field id of each open struct, fields are written as deltas from it
+    int depth;
+}ThriftWriter;
+typedef struct{
+    FILE *file;
+    long long offset;
+    bool failed;
+    ReactionEvent *rows;        // the row group being filled, the only thing that grows with the row group size
+    int rowCount;
+    char player[EXPORT_NAME_MAX];
+    unsigned char *page;        // one column of the row group, encoded
+    ThriftWriter thrift;
+    ExportChunk *chunks;        // every column of every row group written, the footer needs them
+    int *groupRows;
+    int groupCount;
+    int groupCapacity;
+    long long totalRows;
+}EventExport;
+static void PutThriftByte(ThriftWriter *w, unsigned char byte)
+{
+    if (w->size == w->capacity)
+    {
+        w->capacity = w->capacity > 0 ? w->capacity*2 : 4096;
+        w->data = realloc(w->data, w->capacity);
+    }
+    w->data[w->size++] = byte;
+}
+static void PutThriftVarint(ThriftWriter *w, unsigned long long value)
+{
+    for (; value >= 0x80; value >>= 7) PutThriftByte(w, (unsigned char)(value | 0x80));
+    PutThriftByte(w, (unsigned char)value);
+}
+static void PutThriftField(ThriftWriter *w, int id, int type)
+{
+    // thrift compact protocol, ids close to the previous one fit in the type byte
+    int delta = id - w->last[w->depth];
+    if (delta > 0 && delta <= 15) PutThriftByte(w, (unsigned char)(delta << 4 | type));
+    else
+    {
+        PutThriftByte(w, (unsigned char)type);
+        PutThriftVarint(w, (unsigned int)((id << 1) ^ (id >> 31)));
+    }
+    w->last[w->depth] = id;
+}
+static void PutThriftI32(ThriftWriter *w, int id, int value)
+{
+    PutThriftField(w, id, THRIFT_I32);
+    PutThriftVarint(w, (unsigned int)((value << 1) ^ (value >> 31)));
+}
+static void PutThriftI64(ThriftWriter *w, int id, long long value)
+{
+    PutThriftField(w, id, THRIFT_I64);
+    PutThriftVarint(w, (unsigned long long)((value << 1) ^ (value >> 63)));
+}
+static void PutThriftBinary(ThriftWriter *w, int id, const void *data, int size)
+{
+    // id 0 is a list element, no field header
+    if (id > 0) PutThriftField(w, id, THRIFT_BINARY);
+    PutThriftVarint(w, size);
+    for (int i = 0; i < size; i++) PutThriftByte(w, ((const unsigned char *)data)[i]);
+}
+static void BeginThriftList(ThriftWriter *w, int id, int type, int count)
+{
+    PutThriftField(w, id, THRIFT_LIST);
+    if (count < 15) PutThriftByte(w, (unsigned char)(count << 4 | type));
+    else
+    {
+        PutThriftByte(w, (unsigned char)(0xF0 | type));
+        PutThriftVarint(w, count);
+    }
+}
+static void BeginThriftStruct(ThriftWriter *w, int id)
+{
+    if (id > 0) PutThriftField(w, id, THRIFT_STRUCT);
+    w->last[++w->depth] = 0;
+}
+static void EndThriftStruct(ThriftWriter *w)
+{
+    PutThriftByte(w, 0);
+    w->depth--;
+}
+static unsigned int Crc32(const unsigned char *data, int size)
+{
+    static unsigned int table[256];
+    if (table[1] == 0)
+        for (unsigned int i = 0; i < 256; i++)
+        {
+            unsigned int c = i;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    unsigned int crc = 0xFFFFFFFFu;
+    for (int i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+static void WriteExportBytes(EventExport *e, const void *data, int size)
+{
+    if (fwrite(data, 1, size, e->file) != (size_t)size) e->failed = true;
+    e->offset += size;
+}
+static const char *GetExportString(const EventExport *e, const ReactionEvent *event, int column)
+{
+    static const char *eventNames[EVENT_TYPE_COUNT] = { "round_start", "spawn", "hit", "miss", "round_end" };
+    static const char *partNames[HITBOX_PART_COUNT] = { "head", "body", "limb" };
+    if (column == EXPORT_PLAYER) return e->player;
+    if (column == EXPORT_EVENT) return event->type < EVENT_TYPE_COUNT ? eventNames[event->type] : "";
+    // only a humanoid hit has a part
+    return event->type == EVENT_HIT && event->humanoid && event->part < HITBOX_PART_COUNT ? partNames[event->part] : "";
+}
+static float GetExportFloat(const ReactionEvent *event, int column)
+{
+    switch (column)
+    {
+        case EXPORT_TIME: return event->time;
+        case EXPORT_YAW: return event->yaw;
+        case EXPORT_PITCH: return event->pitch;
+        case EXPORT_X: return event->position.x;
+        case EXPORT_Y: return event->position.y;
+        case EXPORT_Z: return event->position.z;
+        case EXPORT_SIZE: return event->size;
+        default: return event->reaction;
+    }
+}
+static void SetExportStats(ExportChunk *chunk, const void *min, int minSize, const void *max, int maxSize)
+{
+    memcpy(chunk->min, min, minSize);
+    memcpy(chunk->max, max, maxSize);
+    chunk->minSize = minSize;
+    chunk->maxSize = maxSize;
+}
+static int CompareExportStrings(const char *a, int aSize, const char *b, int bSize)
+{
+    int order = memcmp(a, b, aSize < bSize ? aSize : bSize);
+    return order != 0 ? order : aSize - bSize;
+}
+static int EncodeExportColumn(EventExport *e, int column, ExportChunk *chunk)
+{
+    // plain values, floats split into byte planes first so the exponent bytes sit together and compress
+    unsigned char *out = e->page;
+    int count = e->rowCount;
+    const ReactionEvent *rows = e->rows;
+    chunk->encoding = PARQUET_PLAIN;
+    switch (exportColumns[column].type)
+    {
+        case PARQUET_FLOAT:
+        {
+            chunk->encoding = PARQUET_BYTE_STREAM_SPLIT;
+            float min = GetExportFloat(&rows[0], column), max = min;
+            for (int i = 0; i < count; i++)
+            {
+                float value = GetExportFloat(&rows[i], column);
+                unsigned char bytes[4];
+                memcpy(bytes, &value, 4);
+                for (int b = 0; b < 4; b++) out[b*count + i] = bytes[b];
+                if (value < min) min = value;
+                if (value > max) max = value;
+            }
+            SetExportStats(chunk, &min, 4, &max, 4);
+            return count*4;
+        }
+        case PARQUET_INT32:
+        {
+            int min = INT_MAX, max = INT_MIN;
+            for (int i = 0; i < count; i++)
+            {
+                int value = column == EXPORT_SLOT ? rows[i].slot : rows[i].value;
+                memcpy(out + i*4, &value, 4);
+                if (value < min) min = value;
+                if (value > max) max = value;
+            }
+            SetExportStats(chunk, &min, 4, &max, 4);
+            return count*4;
+        }
+        case PARQUET_INT64:
+        {
+            long long min = LLONG_MAX, max = LLONG_MIN;
+            for (int i = 0; i < count; i++)
+            {
+                long long value = rows[i].round*1000;
+                memcpy(out + i*8, &value, 8);
+                if (value < min) min = value;
+                if (value > max) max = value;
+            }
+            SetExportStats(chunk, &min, 8, &max, 8);
+            return count*8;
+        }
+        case PARQUET_BOOLEAN:
+        {
+            unsigned char min = 1, max = 0;
+            memset(out, 0, (count + 7)/8);
+            for (int i = 0; i < count; i++)
+            {
+                unsigned char value = rows[i].humanoid != 0;
+                out[i/8] |= value << (i % 8);
+                if (value < min) min = value;
+                if (value > max) max = value;
+            }
+            SetExportStats(chunk, &min, 1, &max, 1);
+            return (count + 7)/8;
+        }
+        default:
+        {
+            int size = 0;
+            const char *min = GetExportString(e, &rows[0], column), *max = min;
+            for (int i = 0; i < count; i++)
+            {
+                const char *value = GetExportString(e, &rows[i], column);
+                int length = (int)strlen(value);
+                memcpy(out + size, &length, 4);
+                memcpy(out + size + 4, value, length);
+                size += 4 + length;
+                if (CompareExportStrings(value, length, min, (int)strlen(min)) < 0) min = value;
+                if (CompareExportStrings(value, length, max, (int)strlen(max)) > 0) max = value;
+            }
+            SetExportStats(chunk, min, (int)strlen(min), max, (int)strlen(max));
+            return size;
+        }
+    }
+}
+static void FlushExportRowGroup(EventExport *e)
+{
+    if (e->rowCount == 0) return;
+    if (e->groupCount == e->groupCapacity)
+    {
+        e->groupCapacity = e->groupCapacity > 0 ? e->groupCapacity*2 : 16;
+        e->chunks = realloc(e->chunks, e->groupCapacity*EXPORT_COLUMN_COUNT*sizeof(ExportChunk));
+        e->groupRows = realloc(e->groupRows, e->groupCapacity*sizeof(int));
+    }
+    for (int column = 0; column < EXPORT_COLUMN_COUNT; column++)
+    {
+        // each column is compressed on its own and kept raw when gzip doesn't pay, a reader only inflates the columns it asks for
+        ExportChunk *chunk = &e->chunks[e->groupCount*EXPORT_COLUMN_COUNT + column];
+        chunk->offset = e->offset;
+        chunk->rawSize = EncodeExportColumn(e, column, chunk);
+        int deflatedSize = 0;
+        unsigned char *deflated = CompressData(e->page, chunk->rawSize, &deflatedSize);
+        bool gzip = deflated != NULL && deflatedSize + 18 < chunk->rawSize;
+        chunk->codec = gzip ? PARQUET_GZIP : PARQUET_UNCOMPRESSED;
+        chunk->storedSize = gzip ? deflatedSize + 18 : chunk->rawSize;
+
+        ThriftWriter *w = &e->thrift;
+        w->size = 0;
+        BeginThriftStruct(w, 0);
+        PutThriftI32(w, 1, 0);                 // DATA_PAGE
+        PutThriftI32(w, 2, chunk->rawSize);
+        PutThriftI32(w, 3, chunk->storedSize);
+        BeginThriftStruct(w, 5);
+        PutThriftI32(w, 1, e->rowCount);
+        PutThriftI32(w, 2, chunk->encoding);
+        PutThriftI32(w, 3, PARQUET_RLE);       // levels, there are none, every column is required
+        PutThriftI32(w, 4, PARQUET_RLE);
+        EndThriftStruct(w);
+        EndThriftStruct(w);
+        chunk->headerSize = w->size;
+        WriteExportBytes(e, w->data, w->size);
+        if (gzip)
+        {
+            // raylib gives a raw deflate stream, gzip wraps it in a 10 byte header and the crc and length
+            static const unsigned char gzipHeader[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+            unsigned int trailer[2] = { Crc32(e->page, chunk->rawSize), (unsigned int)chunk->rawSize };
+            WriteExportBytes(e, gzipHeader, sizeof(gzipHeader));
+            WriteExportBytes(e, deflated, deflatedSize);
+            WriteExportBytes(e, trailer, sizeof(trailer));
+        }
+        else WriteExportBytes(e, e->page, chunk->rawSize);
+        if (deflated != NULL) MemFree(deflated);
+    }
+    e->groupRows[e->groupCount++] = e->rowCount;
+    e->totalRows += e->rowCount;
+    e->rowCount = 0;
+}
+static void WriteExportFooter(EventExport *e)
+{
+    ThriftWriter *w = &e->thrift;
+    w->size = 0;
+    BeginThriftStruct(w, 0);
+    PutThriftI32(w, 1, 1);
+    // a flat schema, the root and a required leaf per column
+    BeginThriftList(w, 2, THRIFT_STRUCT, EXPORT_COLUMN_COUNT + 1);
+    BeginThriftStruct(w, 0);
+    PutThriftBinary(w, 4, "schema", 6);
+    PutThriftI32(w, 5, EXPORT_COLUMN_COUNT);
+    EndThriftStruct(w);
+    for (int column = 0; column < EXPORT_COLUMN_COUNT; column++)
+    {
+        BeginThriftStruct(w, 0);
+        PutThriftI32(w, 1, exportColumns[column].type);
+        PutThriftI32(w, 3, 0);                 // REQUIRED
+        PutThriftBinary(w, 4, exportColumns[column].name, (int)strlen(exportColumns[column].name));
+        if (exportColumns[column].converted >= 0) PutThriftI32(w, 6, exportColumns[column].converted);
+        EndThriftStruct(w);
+    }
+    PutThriftI64(w, 3, e->totalRows);
+    BeginThriftList(w, 4, THRIFT_STRUCT, e->groupCount);
+    for (int group = 0; group < e->groupCount; group++)
+    {
+        long long groupSize = 0;
+        BeginThriftStruct(w, 0);
+        BeginThriftList(w, 1, THRIFT_STRUCT, EXPORT_COLUMN_COUNT);
+        for (int column = 0; column < EXPORT_COLUMN_COUNT; column++)
+        {
+            const ExportChunk *chunk = &e->chunks[group*EXPORT_COLUMN_COUNT + column];
+            groupSize += chunk->headerSize + chunk->rawSize;
+            BeginThriftStruct(w, 0);
+            PutThriftI64(w, 2, chunk->offset);
+            BeginThriftStruct(w, 3);
+            PutThriftI32(w, 1, exportColumns[column].type);
+            BeginThriftList(w, 2, THRIFT_I32, 1);
+            PutThriftVarint(w, (unsigned int)(chunk->encoding << 1));
+            BeginThriftList(w, 3, THRIFT_BINARY, 1);
+            PutThriftBinary(w, 0, exportColumns[column].name, (int)strlen(exportColumns[column].name));
+            PutThriftI32(w, 4, chunk->codec);
+            PutThriftI64(w, 5, e->groupRows[group]);
+            PutThriftI64(w, 6, chunk->headerSize + chunk->rawSize);
+            PutThriftI64(w, 7, chunk->headerSize + chunk->storedSize);
+            PutThriftI64(w, 9, chunk->offset);
+            // min/max per row group let a query on a player, a date or a value range skip whole row groups
+            BeginThriftStruct(w, 12);
+            PutThriftI64(w, 3, 0);
+            PutThriftBinary(w, 5, chunk->max, chunk->maxSize);
+            PutThriftBinary(w, 6, chunk->min, chunk->minSize);
+            EndThriftStruct(w);
+            EndThriftStruct(w);
+            EndThriftStruct(w);
+        }
+        PutThriftI64(w, 2, groupSize);
+        PutThriftI64(w, 3, e->groupRows[group]);
+        EndThriftStruct(w);
+    }
+    PutThriftBinary(w, 6, "IncognitoAim", 12);
+    // readers only trust min/max that say how they were ordered, every column sorts by its type
+    BeginThriftList(w, 7, THRIFT_STRUCT, EXPORT_COLUMN_COUNT);
+    for (int column = 0; column < EXPORT_COLUMN_COUNT; column++)
+    {
+        BeginThriftStruct(w, 0);
+        BeginThriftStruct(w, 1);
+        EndThriftStruct(w);
+        EndThriftStruct(w);
+    }
+    EndThriftStruct(w);
+    unsigned int footerSize = w->size;
+    WriteExportBytes(e, w->data, w->size);
+    WriteExportBytes(e, &footerSize, 4);
+    WriteExportBytes(e, "PAR1", 4);
+}
+static bool ExportEventLog(EventExport *e, const char *path, const char *player, ReactionEvent *batch)
+{
+    // read a batch at a time, memory stays the same however long the log is
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+    EventLogHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != EVENT_LOG_MAGIC || header.version != EVENT_LOG_VERSION ||
+        header.eventSize != sizeof(ReactionEvent) || fseek(file, header.headerSize, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+    // a row group holds one player, so its min/max is enough to skip everyone else
+    FlushExportRowGroup(e);
+    snprintf(e->player, sizeof(e->player), "%s", player);
+    EventBatchHeader batchHeader;
+    while (fread(&batchHeader, sizeof(batchHeader), 1, file) == 1)
+    {
+        // a log still being written can end in half a batch
+        if (batchHeader.magic != EVENT_BATCH_MAGIC || batchHeader.count == 0 || batchHeader.count > EVENT_QUEUE_SIZE ||
+            fread(batch, sizeof(ReactionEvent), batchHeader.count, file) != batchHeader.count ||
+            ChecksumEvents(batch, batchHeader.count) != batchHeader.checksum) break;
+        for (unsigned int i = 0; i < batchHeader.count; i++)
+        {
+            e->rows[e->rowCount++] = batch[i];
+            if (e->rowCount == EXPORT_ROW_GROUP_ROWS) FlushExportRowGroup(e);
+        }
+    }
+    fclose(file);
+    return true;
+}
+static void GetExportPlayer(const char *path, const char *root, char *player)
+{
+    // the folder a log is in under the exported one names the player, team/alice/incognitoaim.events is alice
+    const char *relative = path;
+    size_t rootLength = root != NULL ? strlen(root) : 0;
+    if (rootLength > 0 && strncmp(path, root, rootLength) == 0) relative = path + rootLength;
+    while (*relative == '/' || *relative == '\\') relative++;
+    const char *slash = strrchr(relative, '/');
+    const char *backslash = strrchr(relative, '\\');
+    if (backslash > slash) slash = backslash;
+    if (slash != NULL) snprintf(player, EXPORT_NAME_MAX, "%.*s", (int)(slash - relative), relative);
+    else snprintf(player, EXPORT_NAME_MAX, "%s", GetFileNameWithoutExt(relative));
+}
+int RunEventExport(const char *outPath, const char *source)
+{
+    char ownLog[512];
+    if (source == NULL)
+    {
+        snprintf(ownLog, sizeof(ownLog), "%s%s", GetApplicationDirectory(), EVENT_LOG_FILE_NAME);
+        source = ownLog;
+    }
+    bool single = IsPathFile(source);
+    FilePathList paths = { 0 };
+    if (!single) paths = LoadDirectoryFilesEx(source, ".events", true);
+    int count = single ? 1 : paths.count;
+
+    EventExport e = { 0 };
+    e.file = fopen(outPath, "wb");
+    if (e.file == NULL)
+    {
+        printf("can't write %s\n", outPath);
+        if (!single) UnloadDirectoryFiles(paths);
+        return 1;
+    }
+    e.rows = malloc(EXPORT_ROW_GROUP_ROWS*sizeof(ReactionEvent));
+    e.page = malloc(EXPORT_ROW_GROUP_ROWS*(4 + EXPORT_NAME_MAX));
+    ReactionEvent *batch = malloc(EVENT_QUEUE_SIZE*sizeof(ReactionEvent));
+    double start = ClockSeconds();
+    WriteExportBytes(&e, "PAR1", 4);
+    int exported = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const char *path = single ? source : paths.paths[i];
+        char player[EXPORT_NAME_MAX];
+        GetExportPlayer(path, single ? NULL : source, player);
+        if (ExportEventLog(&e, path, player, batch)) exported++;
+        else printf("skipped %s, not an event log\n", path);
+    }
+    FlushExportRowGroup(&e);
+    WriteExportFooter(&e);
+    if (fclose(e.file) != 0) e.failed = true;
+    double seconds = ClockSeconds() - start;
+
+    if (e.failed) printf("failed writing %s\n", outPath);
+    else printf("%lld events from %d logs in %d row groups, %.2f MB (%.1f bytes an event) in %.2f s -> %s\n", e.totalRows, exported,
+                e.groupCount, e.offset/1048576.0, e.totalRows > 0 ? (double)e.offset/e.totalRows : 0.0, seconds, outPath);
+    free(batch);
+    free(e.page);
+    free(e.rows);
+    free(e.chunks);
+    free(e.groupRows);
+    free(e.thrift.data);
+    if (!single) UnloadDirectoryFiles(paths);
+    return !e.failed && exported > 0 ? 0 : 1;
+}
+#pragma endregion
+#pragma region Session Replay
+bool CheckSessionFile(const MappedFile *file, SessionHeader *header, const ReactionInput **inputs)
+{
+    // sessions from before input capture can't be replayed
+    *header = (SessionHeader){ 0 };
+    if (file->data == NULL || file->size < sizeof(SessionHeader)) return false;
+    memcpy(header, file->data, sizeof(SessionHeader));
+    size_t inputOffset = sizeof(SessionHeader) + (size_t)header->summaryCount*sizeof(AimSummary);
+    if (header->magic != SESSION_MAGIC || header->version != SESSION_VERSION || header->headerSize != sizeof(SessionHeader) ||
+        header->summarySize != sizeof(AimSummary) || header->inputSize != sizeof(ReactionInput) ||
+        header->summaryCount < 0 || header->inputCount < 0 ||
+        file->size != inputOffset + (size_t)header->inputCount*sizeof(ReactionInput)) return false;
+    // the inputs sit at a 4 byte aligned offset, mmap keeps them aligned for the reads
+    *inputs = (const ReactionInput *)(file->data + inputOffset);
+    return true;
+}
+ReactionSnapshot BeginReactionSnapshot(const SessionHeader *header, ReactionRules rules)
+{
+    ReactionSnapshot snapshot = { 0 };
+    snapshot.game.rules = rules;
+    snapshot.game.ballSize = header->ballSize;
+    snapshot.game.gameState = PLAY;
+    InitReactionRound(&snapshot.game, header->seed);
+    snapshot.camera = header->camera;
+    snapshot.view = (Camera){ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 100.0f }, { 0.0f, 1.0f, 0.0f }, 50.0f, 0 };
+    return snapshot;
+}
+void StepReactionSnapshot(ReactionSnapshot *snapshot, const SessionHeader *header, ReactionInput input)
+{
+    StepReactionGame(&snapshot->game, &snapshot->camera, &snapshot->view, header->mouseSensitivity, input);
+    if (input.buttons & REACTION_INPUT_CLICK)
+    {
+        unsigned char parts[NUM_BALLS_ON_SCREEN];
+        int hits = FindReactionHits(&snapshot->game, &snapshot->view, parts);
+        ApplyReactionClick(&snapshot->game, hits, parts);
+    }
+    snapshot->frame++;
+    snapshot->time += input.dt;
+}
+bool LoadSessionReplay(SessionReplay *replay, const char *path)
+{
+    *replay = (SessionReplay){ 0 };
+    replay->file = MapFile(path);
+    if (!CheckSessionFile(&replay->file, &replay->header, &replay->inputs))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: [%s] Not a replayable session", path);
+        UnmapFile(&replay->file);
+        return false;
+    }
+    // one pass over the whole session drops a keyframe every REPLAY_KEYFRAME_SECONDS
+    double start = ClockSeconds();
+    int capacity = (int)(replay->header.duration/REPLAY_KEYFRAME_SECONDS) + 2;
+    replay->keyframes = malloc(capacity*sizeof(ReactionSnapshot));
+    ReactionSnapshot snapshot = BeginReactionSnapshot(&replay->header, replay->header.rules);
+    replay->keyframes[replay->keyframeCount++] = snapshot;
+    float next = REPLAY_KEYFRAME_SECONDS;
+    for (int i = 0; i < replay->header.inputCount; i++)
+    {
+        StepReactionSnapshot(&snapshot, &replay->header, replay->inputs[i]);
+        if (snapshot.time >= next)
+        {
+            if (replay->keyframeCount == capacity)
+            {
+                capacity *= 2;
+                replay->keyframes = realloc(replay->keyframes, capacity*sizeof(ReactionSnapshot));
+            }
+            replay->keyframes[replay->keyframeCount++] = snapshot;
+            next = snapshot.time + REPLAY_KEYFRAME_SECONDS;
+        }
+    }
+    replay->length = snapshot.time;
+    replay->state = replay->keyframes[0];
+    TraceLog(LOG_INFO, "REPLAY: [%s] %d frames, %d keyframes built in %.1f ms", path, replay->header.inputCount,
+             replay->keyframeCount, (ClockSeconds() - start)*1000.0);
+    return true;
+}
+void UnloadSessionReplay(SessionReplay *replay)
+{
+    free(replay->keyframes);
+    UnmapFile(&replay->file);
+    *replay = (SessionReplay){ 0 };
+}
+void SeekSessionReplay(SessionReplay *replay, float time)
+{
+    // going forward from where we are is cheaper than a keyframe when it is close, otherwise restore the last keyframe at or before the time
+    if (replay->keyframeCount == 0) return;
+    if (time < replay->state.time || time - replay->state.time > REPLAY_KEYFRAME_SECONDS)
+    {
+        int low = 0, high = replay->keyframeCount - 1;
+        while (low < high)
+        {
+            int mid = (low + high + 1)/2;
+            if (replay->keyframes[mid].time <= time) low = mid;
+            else high = mid - 1;
+        }
+        replay->state = replay->keyframes[low];
+    }
+    while (replay->state.frame < replay->header.inputCount && replay->state.time + replay->inputs[replay->state.frame].dt <= time)
+        StepReactionSnapshot(&replay->state, &replay->header, replay->inputs[replay->state.frame]);
+}
+#pragma endregion
+#pragma region Replay Viewer
+static const float replaySpeeds[] = { 0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f };
+static const int replaySpeedCount = sizeof(replaySpeeds)/sizeof(replaySpeeds[0]);
+bool StartReplayViewer(const char *path, const char *ghostPath)
+{
+    StopReplayViewer();
+    ReplayViewer *viewer = &replayViewer;
+    if (!LoadSessionReplay(&viewer->replay, path)) return false;
+    viewer->showGhost = ghostPath != NULL && LoadSessionReplay(&viewer->ghost, ghostPath);
+    viewer->time = 0.0f;
+    viewer->speedIndex = 3;
+    viewer->paused = false;
+    // the replay draws through the drill's own globals, put them back when it closes
+    viewer->live = (ReactionSnapshot){ 0, 0.0f, reactionGame, camSettings, camera };
+    viewer->returnState = game.appState;
+    game.appState = REPLAY;
+    EnableCursor();
+    LayoutReplayViewer();
+    return true;
+}
+void StopReplayViewer()
+{
+    ReplayViewer *viewer = &replayViewer;
+    if (game.appState != REPLAY) return;
+    reactionGame = viewer->live.game;
+    camSettings = viewer->live.camera;
+    camera = viewer->live.view;
+    game.appState = viewer->returnState;
+    UnloadSessionReplay(&viewer->replay);
+    UnloadSessionReplay(&viewer->ghost);
+}
+void LayoutReplayViewer()
+{
+    replayViewer.timeline = (Rectangle){ screenWidth*.1f, screenHeight*.92f, screenWidth*.8f, 12.0f };
+}
+void UpdateReplayViewer()
+{
+    ReplayViewer *viewer = &replayViewer;
+    float length = viewer->replay.length;
+    if (IsKeyPressed(KEY_BACKSPACE))
+    {
+        StopReplayViewer();
+        return;
+    }
+    if (IsKeyPressed(KEY_SPACE))
+    {
+        // play again from the start once the end is reached
+        if (viewer->paused && viewer->time >= length) viewer->time = 0.0f;
+        viewer->paused = !viewer->paused;
+    }
+    if (IsKeyPressed(KEY_UP) && viewer->speedIndex < replaySpeedCount - 1) viewer->speedIndex++;
+    if (IsKeyPressed(KEY_DOWN) && viewer->speedIndex > 0) viewer->speedIndex--;
+    if (IsKeyPressed(KEY_RIGHT)) viewer->time += REPLAY_SKIP_SECONDS;
+    if (IsKeyPressed(KEY_LEFT)) viewer->time -= REPLAY_SKIP_SECONDS;
+    if (IsKeyPressed(KEY_G) && viewer->ghost.keyframeCount > 0) viewer->showGhost = !viewer->showGhost;
+    // holding the timeline scrubs instead of playing
+    bool scrubbing = IsMouseButtonDown(MOUSE_BUTTON_LEFT) && CheckCollisionPointRec(GetMousePosition(), viewer->timeline);
+    if (!viewer->paused && !scrubbing) viewer->time += dt*replaySpeeds[viewer->speedIndex];
+    viewer->time = Clamp(viewer->time, 0.0f, length);
+    if (viewer->time >= length) viewer->paused = true;
+}
+void DrawReplayViewer()
+{
+    ReplayViewer *viewer = &replayViewer;
+    float length = viewer->replay.length;
+    GuiSliderBar(viewer->timeline, NULL, NULL, &viewer->time, 0.0f, length);
+    SeekSessionReplay(&viewer->replay, viewer->time);
+    if (viewer->showGhost) SeekSessionReplay(&viewer->ghost, viewer->time);
+
+    // the recorded round goes through the same drawing as a live one, in the player's ball color
+    reactionGame = viewer->replay.state.game;
+    reactionGame.ballColor = viewer->live.game.ballColor;
+    camSettings = viewer->replay.state.camera;
+    camera = viewer->replay.state.view;
+    DrawReactionGame();
+
+    if (viewer->showGhost)
+    {
+        // where the other session was looking, projected onto the ball plane through this camera
+        Vector3 direction = Vector3Normalize(Vector3Subtract(viewer->ghost.state.view.target, viewer->ghost.state.view.position));
+        Vector2 aim = GetWorldToScreen(Vector3Add(camera.position, Vector3Scale(direction, 700.0f)), camera);
+        DrawUiText("+", aim.x, aim.y - 10, 20, Fade(BLUE, 0.7f));
+    }
+
+    Rectangle bar = viewer->timeline;
+    int fontSize = 20;
+    DrawUiText(TextFormat("REPLAY %gx%s   %.1f / %.1f s", replaySpeeds[viewer->speedIndex], viewer->paused ? "  paused" : "", viewer->time, length),
+               bar.x, bar.y - fontSize - 6, fontSize, BLACK);
+    DrawUiText("SPACE pause   UP/DOWN speed   LEFT/RIGHT 5 s   G ghost   BACKSPACE back", bar.x, bar.y + bar.height + 6, fontSize/2, BLACK);
+}
+#pragma endregion
+#pragma region Session Re-simulation
+typedef struct{
+    const char *path;
+    long size;
+}ResimFile;
+typedef struct{
+    bool valid;
+    int frames;
+    int recordedScore;
+    int baselineScore;          // recorded rules, should match what was recorded
+    int candidateScore;
+    float baselineAccuracy;
+    float candidateAccuracy;
+}ResimResult;
+typedef struct{
+    ResimFile *files;
+    ResimResult *results;
+    ReactionRules rules;
+}ResimJob;
+static void SimulateSession(const SessionHeader *header, const ReactionInput *inputs, ReactionRules rules, int *score, float *accuracy)
+{
+    ReactionSnapshot snapshot = BeginReactionSnapshot(header, rules);
+    for (int i = 0; i < header->inputCount && snapshot.game.gameState == PLAY; i++) StepReactionSnapshot(&snapshot, header, inputs[i]);
+    *score = snapshot.game.score;
+    *accuracy = snapshot.game.accuracy;
+}
+static void ResimSession(void *ctx, int index)
+{
+    ResimJob *job = ctx;
+    ResimResult *result = &job->results[index];
+    MappedFile file = MapFile(job->files[index].path);
+    SessionHeader header;
+    const ReactionInput *inputs = NULL;
+    if (CheckSessionFile(&file, &header, &inputs))
+    {
+        result->valid = true;
+        result->frames = header.inputCount;
+        result->recordedScore = header.score;
+        SimulateSession(&header, inputs, header.rules, &result->baselineScore, &result->baselineAccuracy);
+        SimulateSession(&header, inputs, job->rules, &result->candidateScore, &result->candidateAccuracy);
+    }
+    UnmapFile(&file);
+}
+static int CompareResimFiles(const void *a, const void *b)
+{
+    long x = ((const ResimFile *)a)->size;
+    long y = ((const ResimFile *)b)->size;
+    return (x < y) - (x > y);
+}
+static int CompareInts(const void *a, const void *b)
+{
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+int RunSessionResim(const char *directory, ReactionRules rules)
+{
+    FilePathList paths = LoadDirectoryFilesEx(directory, ".session", true);
+    int count = paths.count;
+    ResimFile *files = malloc((count > 0 ? count : 1)*sizeof(ResimFile));
+    ResimResult *results = calloc(count > 0 ? count : 1, sizeof(ResimResult));
+    for (int i = 0; i < count; i++) files[i] = (ResimFile){ .path = paths.paths[i], .size = GetFileLength(paths.paths[i]) };
+    // longest sessions first so no thread is left with a big one at the end
+    qsort(files, count, sizeof(ResimFile), CompareResimFiles);
+
+    double start = ClockSeconds();
+    ResimJob job = { .files = files, .results = results, .rules = rules };
+    ParallelFor(count, ResimSession, &job);
+    double seconds = ClockSeconds() - start;
+
+    int valid = 0, reproduced = 0;
+    long long frames = 0;
+    double recorded = 0.0, baseline = 0.0, candidate = 0.0, baselineAccuracy = 0.0, candidateAccuracy = 0.0;
+    int *deltas = malloc((count > 0 ? count : 1)*sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        ResimResult *r = &results[i];
+        if (!r->valid) continue;
+        frames += r->frames;
+        recorded += r->recordedScore;
+        baseline += r->baselineScore;
+        candidate += r->candidateScore;
+        baselineAccuracy += r->baselineAccuracy;
+        candidateAccuracy += r->candidateAccuracy;
+        if (r->baselineScore == r->recordedScore) reproduced++;
+        deltas[valid++] = r->candidateScore - r->baselineScore;
+    }
+    printf("%d sessions, %d skipped (recorded before input capture or unreadable)\n", valid, count - valid);
+    printf("%lld frames twice in %.3f s, %.1f M frames/s on %d threads\n", frames, seconds,
+           seconds > 0.0 ? 2.0*frames/seconds*1e-6 : 0.0, GetWorkerCount());
+    printf("rules: hit padding %.2f, ball spacing %.2f, hit score %d, adaptive %s, motion %d, humanoid %s\n", rules.hitPadding, rules.ballSpacing,
+           rules.hitScore, rules.adaptive ? "on" : "off", rules.motion, rules.humanoid ? "on" : "off");
+    if (valid > 0)
+    {
+        // anything not reproduced was recorded by a build that simulated differently
+        printf("baseline reproduces %d/%d recorded scores\n", reproduced, valid);
+        printf("mean score     recorded %.2f  baseline %.2f  candidate %.2f  delta %+.2f\n",
+               recorded/valid, baseline/valid, candidate/valid, (candidate - baseline)/valid);
+        printf("mean accuracy  baseline %.3f  candidate %.3f\n", baselineAccuracy/valid, candidateAccuracy/valid);
+        qsort(deltas, valid, sizeof(int), CompareInts);
+        printf("score delta    min %+d  p5 %+d  p25 %+d  p50 %+d  p75 %+d  p95 %+d  max %+d\n", deltas[0],
+               deltas[(int)(0.05*(valid - 1))], deltas[(int)(0.25*(valid - 1))], deltas[(valid - 1)/2],
+               deltas[(int)(0.75*(valid - 1))], deltas[(int)(0.95*(valid - 1))], deltas[valid - 1]);
+
+        // histogram of the deltas, at most 21 buckets
+        int low = deltas[0], high = deltas[valid - 1];
+        int width = (high - low)/21 + 1;
+        int buckets = (high - low)/width + 1;
+        int histogram[21] = { 0 };
+        int most = 0;
+        for (int i = 0; i < valid; i++) histogram[(deltas[i] - low)/width]++;
+        for (int b = 0; b < buckets; b++) if (histogram[b] > most) most = histogram[b];
+        for (int b = 0; b < buckets; b++)
+        {
+            char bar[51] = { 0 };
+            int length = (int)(50.0*histogram[b]/most + 0.5);
+            memset(bar, '#', length);
+            if (width == 1) printf("%+6d %8d %s\n", low + b*width, histogram[b], bar);
+            else printf("%+6d..%+-6d %8d %s\n", low + b*width, low + (b + 1)*width - 1, histogram[b], bar);
+        }
+    }
+    free(deltas);
+    free(results);
+    free(files);
+    UnloadDirectoryFiles(paths);
+    return valid > 0 ? 0 : 1;
 }
-#pragma endregion
 #pragma endregion
 #pragma region Tracking game
 void UpdateTrackGame()